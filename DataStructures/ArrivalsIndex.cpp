@@ -0,0 +1,100 @@
+/*
+ * ArrivalsIndex.cpp
+ */
+
+#include <algorithm>
+#include "ArrivalsIndex.h"
+
+ArrivalsIndex::ArrivalsIndex(std::shared_ptr<const FlowNetwork> network): network(std::move(network)) {
+    prepare();
+    FlowScratch scratch;
+    for (int v = 0; v < this->network->getNumVertex(); v++) compute(v, scratch);
+}
+
+ArrivalsIndex::ArrivalsIndex(std::shared_ptr<const FlowNetwork> network, const ArrivalsIndex &before,
+                             const std::vector<int> &changed): network(std::move(network)) {
+    prepare();
+    const FlowNetwork &net = *this->network, &old = *before.network;
+    int n = net.getNumVertex();
+    std::vector<char> stale(n, 0);      // parts computed again
+    for (int id : changed) {
+        int v = net.index(id);
+        if (v != -1) stale[part[v]] = 1;
+    }
+    std::vector<int> was(n);            // position of each vertex in the other network
+    for (int v = 0; v < n; v++) {
+        was[v] = old.index(net.id(v));
+        if (was[v] == -1) stale[part[v]] = 1;
+    }
+    auto now = [&](std::vector<int> vertices) {
+        for (int &u : vertices) u = net.index(old.id(u));
+        return vertices;
+    };
+
+    FlowScratch scratch;
+    for (int v = 0; v < n; v++) {
+        if (stale[part[v]]) {
+            compute(v, scratch);
+            continue;
+        }
+        int w = was[v];
+        flows[v] = before.flows[w];
+        sinkSide[v] = now(before.sinkSide[w]);
+        // the arcs of the part kept their order, each vertex only starts at another offset
+        for (int k = 0; k < net.offsets[v + 1] - net.offsets[v]; k++) {
+            int a = net.offsets[v] + k, b = old.offsets[w] + k;
+            if (a < net.rev[a]) users[a] = now(before.users[b]);
+        }
+    }
+}
+
+void ArrivalsIndex::prepare() {
+    const FlowNetwork &net = *network;
+    int n = net.getNumVertex(), m = net.getNumArcs();
+    flows.assign(n, 0);
+    terminal.assign(n, 0);
+    for (int v : net.terminals) terminal[v] = 1;
+    users.assign(m, {});
+    sinkSide.assign(n, {});
+    part = net.parts();
+}
+
+void ArrivalsIndex::compute(int v, FlowScratch &scratch) {
+    const FlowNetwork &net = *network;
+    int n = net.getNumVertex(), m = net.getNumArcs();
+    flows[v] = net.arrivals(net.id(v), scratch);
+    for (int a = 0; a < m; a++)
+        if (a < net.rev[a] && scratch.flow[a] != 0) users[a].push_back(v);
+    // the last search of the flow stopped at the cut
+    for (int u = 0; u < n; u++)
+        if (u != v && part[u] == part[v] && !((scratch.visited[u >> 6] >> (u & 63)) & 1)) sinkSide[u].push_back(v);
+}
+
+const FlowNetwork &ArrivalsIndex::getNetwork() const {
+    return *network;
+}
+
+double ArrivalsIndex::arrivals(int id) const {
+    int v = network->index(id);
+    return v == -1 ? 0 : flows[v];
+}
+
+std::vector<int> ArrivalsIndex::affected(const FlowScratch &scratch) const {
+    const FlowNetwork &net = *network;
+    std::vector<int> found;
+    for (int a : scratch.closedArcs) {
+        int first = std::min(a, net.rev[a]);
+        found.insert(found.end(), users[first].begin(), users[first].end());
+
+        // the tail of a closed arc may be left with a single open edge
+        int u = net.heads[net.rev[a]];
+        if (terminal[u]) continue;
+        int open = 0;
+        for (int b = net.offsets[u]; b < net.offsets[u + 1]; b++) open += net.price[b] >= 0 && !scratch.closed[b];
+        if (open == 1) found.insert(found.end(), sinkSide[u].begin(), sinkSide[u].end());
+    }
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    for (int &v : found) v = net.id(v);
+    return found;
+}
@@ -0,0 +1,70 @@
+/*
+ * ArrivalsIndex.h
+ * Max flow arriving at every vertex of a FlowNetwork (see FlowNetwork::arrivals), with what it takes to tell,
+ * when some arcs are closed, which vertices can receive a different flow.
+ *
+ * For every vertex the index keeps the arc pairs its maximum flow uses and the sink side of its minimum cut
+ * (the vertices the last search of Edmonds-Karp could not reach). Closing arcs leaves the flow of a vertex unchanged when
+ *  - none of the closed arcs carries its flow: the same flow is still feasible, so it cannot decrease, and
+ *  - every vertex that becomes a terminal lies on the source side of its cut: the cut still separates all the
+ *    terminals from the vertex and closing arcs cannot widen it, so it cannot increase.
+ * Only the vertices listed under the closed arcs or under the new terminals need to be computed again.
+ *
+ * The flow of a vertex only depends on the connected part of the network it lies in, so the cut of a vertex only keeps
+ * the vertices of its part, and after a change to the network only the parts that hold a changed vertex are computed again.
+ */
+
+#ifndef DA_TP_CLASSES_ARRIVALSINDEX
+#define DA_TP_CLASSES_ARRIVALSINDEX
+
+#include <memory>
+#include <vector>
+#include "FlowNetwork.h"
+
+class ArrivalsIndex {
+public:
+    /*
+     * Computes the arrivals at every vertex of a network, which must not change while the index exists.
+     * Complexity O(|V|^2*|E|^2)
+     */
+    explicit ArrivalsIndex(std::shared_ptr<const FlowNetwork> network);
+    /*
+     * Index of a network that differs from the network of another index only in the parts that hold one of the changed
+     * vertices (by id) or a vertex the other network does not have: the vertices of those parts are computed again and
+     * the others are taken from the other index. Every other part must have the same vertices and arcs, in the same order.
+     * Complexity O(|V|+|E|) plus O(c*|V|*|E|^2) for the c vertices computed again
+     */
+    ArrivalsIndex(std::shared_ptr<const FlowNetwork> network, const ArrivalsIndex &before, const std::vector<int> &changed);
+
+    const FlowNetwork &getNetwork() const;
+
+    /*
+     * Max flow arriving at a vertex (by id) with every arc open, 0 if it does not exist.
+     */
+    double arrivals(int id) const;
+
+    /*
+     * Ids of the vertices whose arrivals may change with the arcs closed in scratch, the others keep theirs.
+     * Complexity O(c + a) for c closed arcs and a vertices listed under them.
+     */
+    std::vector<int> affected(const FlowScratch &scratch) const;
+
+private:
+    std::shared_ptr<const FlowNetwork> network;
+    std::vector<double> flows;                  // arrivals at each vertex
+    std::vector<char> terminal;
+    std::vector<int> part;                      // connected part of each vertex
+    std::vector<std::vector<int>> users;        // vertices whose flow uses each arc pair, under its first arc
+    std::vector<std::vector<int>> sinkSide;     // vertices of the same part with each vertex on the sink side of their cut
+
+    /*
+     * Sizes the index and finds the connected parts of the network.
+     */
+    void prepare();
+    /*
+     * Computes the arrivals at a vertex (by position), with the arcs its flow uses and its cut.
+     */
+    void compute(int v, FlowScratch &scratch);
+};
+
+#endif /* DA_TP_CLASSES_ARRIVALSINDEX */
@@ -0,0 +1,254 @@
+/*
+ * BlockCutTree.cpp
+ */
+
+#include <algorithm>
+#include <queue>
+#include "BlockCutTree.h"
+
+BlockCutTree::BlockCutTree(std::shared_ptr<const FlowNetwork> network): network(std::move(network)) {
+    split();
+    buildBlocks();
+}
+
+void BlockCutTree::split() {
+    const FlowNetwork &net = *network;
+    int n = net.getNumVertex();
+    std::vector<int> disc(n, -1), low(n, 0), next(n), parentArc(n, -1);
+    std::vector<int> vertices, edges;      // search stack and the arcs not yet given to a block
+    int time = 0;
+
+    for (int root = 0; root < n; root++) {
+        if (disc[root] != -1) continue;
+        disc[root] = low[root] = time++;
+        next[root] = net.offsets[root];
+        vertices.push_back(root);
+        while (!vertices.empty()) {
+            int v = vertices.back();
+            if (next[v] < net.offsets[v + 1]) {
+                int a = next[v]++;
+                int w = net.heads[a];
+                if (w == v || (parentArc[v] != -1 && a == net.rev[parentArc[v]])) continue;
+                if (disc[w] == -1) {
+                    edges.push_back(a);
+                    parentArc[w] = a;
+                    disc[w] = low[w] = time++;
+                    next[w] = net.offsets[w];
+                    vertices.push_back(w);
+                }
+                else if (disc[w] < disc[v]) {
+                    // back edge, seen first from its lower end
+                    edges.push_back(a);
+                    low[v] = std::min(low[v], disc[w]);
+                }
+                continue;
+            }
+
+            vertices.pop_back();
+            if (parentArc[v] == -1) continue;
+            int u = net.heads[net.rev[parentArc[v]]];
+            low[u] = std::min(low[u], low[v]);
+            if (low[v] >= disc[u]) {
+                // nothing below v reaches above u: the arcs pushed since entering v form a block
+                std::vector<int> arcs;
+                int a;
+                do {
+                    a = edges.back();
+                    edges.pop_back();
+                    arcs.push_back(a);
+                    arcs.push_back(net.rev[a]);
+                } while (a != parentArc[v]);
+                blockArcs.push_back(std::move(arcs));
+            }
+        }
+    }
+}
+
+void BlockCutTree::buildBlocks() {
+    const FlowNetwork &net = *network;
+    int n = net.getNumVertex();
+    int numBlocks = (int) blockArcs.size();
+
+    // vertices of each block and how many blocks each vertex is in
+    std::vector<std::vector<int>> members(numBlocks);
+    std::vector<int> count(n, 0), seen(n, -1), local(n, -1);
+    node.assign(n, -1);
+    arcBlock.assign(net.getNumArcs(), -1);
+    for (int b = 0; b < numBlocks; b++) {
+        for (int a : blockArcs[b]) {
+            arcBlock[a] = b;
+            int v = net.heads[a];
+            if (seen[v] == b) continue;
+            seen[v] = b;
+            members[b].push_back(v);
+            count[v]++;
+            node[v] = b;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (count[v] < 2) continue;
+        node[v] = numBlocks + (int) cuts.size();
+        cuts.push_back(v);
+    }
+
+    // a network of its own for every block with more than two vertices
+    blocks.resize(numBlocks);
+    for (int b = 0; b < numBlocks; b++) {
+        if (members[b].size() <= 2) continue;
+        auto block = std::make_shared<FlowNetwork>();
+        for (int v : members[b]) {
+            local[v] = (int) block->ids.size();
+            block->indexOf[net.ids[v]] = local[v];
+            block->ids.push_back(net.ids[v]);
+            if (!net.limit.empty()) block->limit.push_back(net.limit[v]);
+        }
+        int k = (int) members[b].size();
+        block->offsets.assign(k + 1, 0);
+        for (int a : blockArcs[b]) block->offsets[local[net.heads[net.rev[a]]] + 1]++;
+        for (int v = 0; v < k; v++) block->offsets[v + 1] += block->offsets[v];
+
+        int m = block->offsets[k];
+        block->heads.assign(m, -1);
+        block->rev.assign(m, -1);
+        block->cap.assign(m, 0);
+        block->price.assign(m, -1);
+        block->edges.assign(m, nullptr);
+        block->service.assign(net.service.empty() ? 0 : m, ALL_SERVICES);
+        std::vector<int> free(block->offsets.begin(), block->offsets.end() - 1);
+        std::vector<int> arcOf(blockArcs[b].size());
+        for (size_t i = 0; i < blockArcs[b].size(); i++) {
+            int a = blockArcs[b][i];
+            int c = free[local[net.heads[net.rev[a]]]]++;
+            block->heads[c] = local[net.heads[a]];
+            block->cap[c] = net.cap[a];
+            block->price[c] = net.price[a];
+            if (!net.service.empty()) block->service[c] = net.service[a];
+            arcOf[i] = c;
+        }
+        // arcs were listed in pairs
+        for (size_t i = 0; i < arcOf.size(); i += 2) {
+            block->rev[arcOf[i]] = arcOf[i + 1];
+            block->rev[arcOf[i + 1]] = arcOf[i];
+        }
+        blocks[b] = std::make_shared<const Contraction>(block);
+    }
+    buildTree(members);
+}
+
+void BlockCutTree::buildTree(const std::vector<std::vector<int>> &members) {
+    int numBlocks = (int) blockArcs.size();
+    int numNodes = numBlocks + (int) cuts.size();
+    std::vector<std::vector<int>> adj(numNodes);
+    for (int b = 0; b < numBlocks; b++) {
+        for (int v : members[b]) {
+            if (node[v] < numBlocks) continue;
+            adj[b].push_back(node[v]);
+            adj[node[v]].push_back(b);
+        }
+    }
+
+    parent.assign(numNodes, -1);
+    depth.assign(numNodes, -1);
+    std::queue<int> q;
+    for (int root = 0; root < numNodes; root++) {
+        if (depth[root] != -1) continue;
+        depth[root] = 0;
+        q.push(root);
+        while (!q.empty()) {
+            int x = q.front();
+            q.pop();
+            for (int y : adj[x]) {
+                if (depth[y] != -1) continue;
+                depth[y] = depth[x] + 1;
+                parent[y] = x;
+                q.push(y);
+            }
+        }
+    }
+}
+
+const FlowNetwork &BlockCutTree::getNetwork() const {
+    return *network;
+}
+
+int BlockCutTree::getNumBlocks() const {
+    return (int) blockArcs.size();
+}
+
+std::vector<int> BlockCutTree::getArticulationPoints() const {
+    std::vector<int> ids;
+    for (int v : cuts) ids.push_back(network->id(v));
+    return ids;
+}
+
+int BlockCutTree::vertexOf(int treeNode) const {
+    return network->id(cuts[treeNode - getNumBlocks()]);
+}
+
+bool BlockCutTree::route(int source, int target, std::vector<Hop> &hops) const {
+    hops.clear();
+    int s = network->index(source), t = network->index(target);
+    if (s == -1 || t == -1 || s == t || node[s] == -1 || node[t] == -1) return false;
+
+    // climb from both ends to the lowest common node
+    std::vector<int> up, down;
+    int x = node[s], y = node[t];
+    while (x != y) {
+        if (depth[x] >= depth[y]) {
+            up.push_back(x);
+            x = parent[x];
+        }
+        else {
+            down.push_back(y);
+            y = parent[y];
+        }
+        if (x == -1 || y == -1) return false;
+    }
+    up.push_back(x);
+    up.insert(up.end(), down.rbegin(), down.rend());
+
+    int numBlocks = getNumBlocks();
+    int from = source;
+    for (size_t i = 0; i < up.size(); i++) {
+        if (up[i] >= numBlocks) continue;
+        int to = i + 1 < up.size() ? vertexOf(up[i + 1]) : target;
+        hops.push_back({up[i], from, to});
+        from = to;
+    }
+    return true;
+}
+
+int BlockCutTree::blockOf(int id1, int id2) const {
+    const FlowNetwork &net = *network;
+    int u = net.index(id1), w = net.index(id2);
+    if (u == -1 || w == -1) return -1;
+    for (int a = net.offsets[u]; a < net.offsets[u + 1]; a++)
+        if (net.heads[a] == w) return arcBlock[a];
+    return -1;
+}
+
+int BlockCutTree::sharedBlock(int id1, int id2) const {
+    const FlowNetwork &net = *network;
+    int u = net.index(id1), w = net.index(id2);
+    if (u == -1 || w == -1) return -1;
+    // the block of an arc holds the vertex the arc leaves
+    for (int a = net.offsets[u]; a < net.offsets[u + 1]; a++) {
+        if (arcBlock[a] == -1) continue;
+        for (int b = net.offsets[w]; b < net.offsets[w + 1]; b++)
+            if (arcBlock[b] == arcBlock[a]) return arcBlock[a];
+    }
+    return -1;
+}
+
+double BlockCutTree::blockFlow(const Hop &hop, FlowScratch &scratch) const {
+    if (blocks[hop.block] != nullptr)
+        return blocks[hop.block]->core({hop.from, hop.to}).network.maxFlow(hop.from, hop.to, scratch);
+
+    // the block is one edge, or parallel edges, between the two vertices
+    const FlowNetwork &net = *network;
+    int u = net.index(hop.from), w = net.index(hop.to);
+    double flow = 0;
+    for (int a : blockArcs[hop.block])
+        if (net.heads[net.rev[a]] == u && net.heads[a] == w) flow += net.cap[a];
+    return flow;
+}
@@ -0,0 +1,80 @@
+/*
+ * BlockCutTree.h
+ * Biconnected components (blocks) and articulation points of a FlowNetwork, joined in the block-cut tree.
+ *
+ * Every path between two vertices crosses the same articulation points, the ones on the path of the block-cut tree
+ * between them, so the maximum flow between two vertices is the smallest of the maximum flows across each block on
+ * that path, from the vertex where the flow enters the block to the one where it leaves, and of the limits of the
+ * articulation points in between. Flow that leaves a block
+ * through another articulation point has to come back through it, so it cannot add to the flow across the block.
+ * Each block keeps its own network, contracted (see Contraction), so the flow across a block is computed on the block
+ * alone and is the same for every query that crosses it the same way.
+ */
+
+#ifndef DA_TP_CLASSES_BLOCKCUTTREE
+#define DA_TP_CLASSES_BLOCKCUTTREE
+
+#include <memory>
+#include <vector>
+#include "Contraction.h"
+
+class BlockCutTree {
+public:
+    /*
+     * Crossing of a block, from a vertex to another (by id).
+     */
+    struct Hop {
+        int block, from, to;
+    };
+
+    /*
+     * Splits a network, which must not change while the tree exists, into blocks with an iterative Tarjan's algorithm,
+     * which holds any depth of search. Edges join vertices whatever their direction. Complexity O(|V|+|E|).
+     */
+    explicit BlockCutTree(std::shared_ptr<const FlowNetwork> network);
+
+    const FlowNetwork &getNetwork() const;
+    int getNumBlocks() const;
+    /*
+     * Ids of the vertices whose removal disconnects a part of the network.
+     */
+    std::vector<int> getArticulationPoints() const;
+
+    /*
+     * Blocks crossed on the way from source to target (by id), in order. Returns false if a vertex does not exist,
+     * has no edge, the two are the same or they are not connected. Complexity O(b) for b blocks on the way.
+     */
+    bool route(int source, int target, std::vector<Hop> &hops) const;
+
+    /*
+     * Block of the edges between two vertices (by id), -1 if there is none. Complexity O(d) for the degree of the first.
+     */
+    int blockOf(int id1, int id2) const;
+    /*
+     * Block that holds two vertices (by id), whether or not an edge joins them, -1 if there is none.
+     * Complexity O(d1*d2) for the degrees of the two.
+     */
+    int sharedBlock(int id1, int id2) const;
+
+    /*
+     * Maximum flow across a block, on its own contracted network. Complexity O(k*c^2) for the k vertices kept
+     * and the c chains of the block.
+     */
+    double blockFlow(const Hop &hop, FlowScratch &scratch) const;
+
+private:
+    std::shared_ptr<const FlowNetwork> network;
+    std::vector<std::vector<int>> blockArcs;                // arcs of each block, in both directions
+    std::vector<int> arcBlock;                              // block of each arc, -1 for a loop
+    std::vector<std::shared_ptr<const Contraction>> blocks;  // network of each block, nullptr when its arcs join only two vertices
+    std::vector<int> cuts;                                  // positions of the articulation points
+    std::vector<int> node;                                  // tree node of each vertex: its block, or numBlocks + its index in cuts if it is an articulation point, -1 if it has no edge
+    std::vector<int> parent, depth;                         // of the tree nodes, rooted at one node of every component
+
+    void split();
+    void buildBlocks();
+    void buildTree(const std::vector<std::vector<int>> &members);
+    int vertexOf(int treeNode) const;
+};
+
+#endif /* DA_TP_CLASSES_BLOCKCUTTREE */
@@ -0,0 +1,96 @@
+/*
+ * CapacitySensitivity.cpp
+ */
+
+#include <algorithm>
+#include <functional>
+#include "CapacitySensitivity.h"
+#include "Heap.h"
+
+CapacitySensitivity::CapacitySensitivity(const FlowNetwork &network, int source, int target)
+        : network(network), source(network.index(source)), target(network.index(target)) {
+    if (this->source == -1 || this->target == -1 || this->source == this->target) return;
+    flow = this->network.maxFlow(source, target, residual);
+    fromSource = widest(this->source, false);
+    toTarget = widest(this->target, true);
+
+    const FlowNetwork &net = this->network;
+    for (int u = 0; u < net.getNumVertex(); u++) {
+        if (fromSource[u] <= 0) continue;
+        for (int a = net.offsets[u]; a < net.offsets[u + 1]; a++)
+            if (net.edges[a] != nullptr && toTarget[net.heads[a]] > 0) candidates.push_back(a);
+    }
+}
+
+std::vector<double> CapacitySensitivity::widest(int start, bool backwards) const {
+    const FlowNetwork &net = network;
+    std::vector<double> width(net.getNumVertex(), 0);
+    width[start] = INF;
+    using Entry = std::pair<double, int>;
+    Heap<Entry, std::greater<Entry>> heap;
+    heap.insert({INF, start});
+    while (!heap.empty()) {
+        Entry top = heap.extractMin();
+        int v = top.second;
+        if (top.first != width[v]) continue;
+        for (int a = net.offsets[v]; a < net.offsets[v + 1]; a++) {
+            // backwards, v is reached through the arc into it, the reverse of a
+            int b = backwards ? net.rev[a] : a;
+            double w = std::min(width[v], net.cap[b] - residual.flow[b]);
+            if (w <= width[net.heads[a]]) continue;
+            width[net.heads[a]] = w;
+            heap.insert({w, net.heads[a]});
+        }
+    }
+    return width;
+}
+
+double CapacitySensitivity::getFlow() const {
+    return flow;
+}
+
+std::vector<CapacitySensitivity::Upgrade> CapacitySensitivity::upgrades(double extra, int checks) {
+    std::vector<Upgrade> found;
+    if (extra <= 0) return found;
+    bool settled = network.limit.empty();
+    for (int a : candidates) {
+        int u = network.heads[network.rev[a]], v = network.heads[a];
+        double estimate = std::min(fromSource[u], toTarget[v]);
+        double gain = settled ? std::min(extra, estimate) : 0;
+        found.push_back({network.id(u), network.id(v), estimate, gain, settled && estimate >= extra});
+    }
+    std::sort(found.begin(), found.end(), [](const Upgrade &x, const Upgrade &y) {
+        if (x.from != y.from || x.to != y.to) return x.from != y.from ? x.from < y.from : x.to < y.to;
+        return x.estimate > y.estimate;
+    });
+    // parallel edges gain as much as each other
+    found.erase(std::unique(found.begin(), found.end(), [](const Upgrade &x, const Upgrade &y) {
+        return x.from == y.from && x.to == y.to;
+    }), found.end());
+    std::sort(found.begin(), found.end(), [](const Upgrade &x, const Upgrade &y) {
+        return x.estimate != y.estimate ? x.estimate > y.estimate : x.from != y.from ? x.from < y.from : x.to < y.to;
+    });
+
+    FlowScratch scratch;
+    for (auto &upgrade : found) {
+        if (upgrade.verified || checks <= 0) continue;
+        checks--;
+        int u = network.index(upgrade.from), v = network.index(upgrade.to);
+        int arc = -1;
+        for (int a = network.offsets[u]; a < network.offsets[u + 1] && arc == -1; a++)
+            if (network.heads[a] == v && network.edges[a] != nullptr) arc = a;
+        scratch = residual;
+        network.cap[arc] += extra;
+        upgrade.gain = network.resumeMaxFlow(network.id(source), network.id(target), scratch);
+        network.cap[arc] -= extra;
+        upgrade.verified = true;
+    }
+    // a station at its limit may leave a candidate with nothing to gain
+    found.erase(std::remove_if(found.begin(), found.end(), [](const Upgrade &x) {
+        return x.verified && x.gain <= 0;
+    }), found.end());
+    std::stable_sort(found.begin(), found.end(), [](const Upgrade &x, const Upgrade &y) {
+        return x.gain > y.gain;
+    });
+    return found;
+}
@@ -0,0 +1,58 @@
+/*
+ * CapacitySensitivity.h
+ * Which edges of a FlowNetwork are worth widening to raise the max flow between two vertices, from a single max flow.
+ *
+ * Widening an edge u->v can only raise the flow if, in the residual graph of the max flow, u can be reached from the
+ * source and the target can be reached from v: the edge is then full and crosses a minimum cut. Every other edge would
+ * gain nothing and is left out without a max flow of its own. A candidate gains one train per unit of extra capacity up
+ * to what the residual graph lets through it: at least the width of the widest residual path from the source to u
+ * and from v to the target, its estimate, and never more than the extra capacity. A candidate whose estimate reaches
+ * the extra capacity gains all of it; the others, best estimate first, are checked by resuming Edmonds-Karp from the
+ * max flow with the edge widened, instead of starting over. Stations with a limit of throughput may hold back a widest
+ * path, so on a network that has them the estimates only rank the candidates and every gain needs a check.
+ */
+
+#ifndef DA_TP_CLASSES_CAPACITYSENSITIVITY
+#define DA_TP_CLASSES_CAPACITYSENSITIVITY
+
+#include <vector>
+#include "FlowNetwork.h"
+
+class CapacitySensitivity {
+public:
+    struct Upgrade {
+        int from, to;       // ids of the ends of the edge, in the direction of the flow
+        double estimate;    // flow that a widest path through the edge adds with unlimited capacity
+        double gain;        // gain of widening the edge by the extra capacity, a lower bound unless verified
+        bool verified;
+    };
+
+    /*
+     * Runs the max flow from source to target (by id) on a copy of a network. Complexity O(|V|*|E|^2).
+     */
+    CapacitySensitivity(const FlowNetwork &network, int source, int target);
+
+    double getFlow() const;
+
+    /*
+     * Every edge whose widening by extra raises the flow, with its gain, largest gain first, each pair of vertices once.
+     * At most checks candidates are checked with a resumed max flow. Complexity O(c*log(c) + k*|V|*|E|*p) for c candidates,
+     * k checked and p augmenting paths each.
+     */
+    std::vector<Upgrade> upgrades(double extra, int checks);
+
+private:
+    FlowNetwork network;        // copy, whose edges are widened one at a time while checking
+    int source, target;         // positions
+    double flow = 0;
+    FlowScratch residual;       // the max flow, copied for every check
+    std::vector<int> candidates;                // full arcs from the source side to the target side
+    std::vector<double> fromSource, toTarget;   // width of the widest residual path from the source and to the target
+
+    /*
+     * Widest residual paths from a vertex, or to it when backwards. Complexity O(|E|*log(|E|)).
+     */
+    std::vector<double> widest(int start, bool backwards) const;
+};
+
+#endif /* DA_TP_CLASSES_CAPACITYSENSITIVITY */
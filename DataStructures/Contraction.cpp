@@ -0,0 +1,218 @@
+/*
+ * Contraction.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "Contraction.h"
+
+Contraction::Contraction(std::shared_ptr<const FlowNetwork> network): network(std::move(network)) {
+    const FlowNetwork &net = *this->network;
+    int n = net.getNumVertex();
+
+    // terminals stay, so do vertices without exactly two neighbours
+    std::vector<char> isKept(n, 0);
+    for (int v : net.terminals) isKept[v] = 1;
+    for (int v = 0; v < n; v++) {
+        int first = -1, second = -1;
+        bool more = false;
+        for (int a = net.offsets[v]; a < net.offsets[v + 1] && !more; a++) {
+            int w = net.heads[a];
+            if (w == first || w == second) continue;
+            if (w == v || second != -1) more = true;
+            else if (first == -1) first = w;
+            else second = w;
+        }
+        if (second == -1 || more) isKept[v] = 1;
+    }
+
+    chainOf.assign(n, -1);
+    positionOf.assign(n, -1);
+    std::vector<char> used(net.getNumArcs(), 0);
+    for (int v = 0; v < n; v++) {
+        if (!isKept[v]) continue;
+        for (int a = net.offsets[v]; a < net.offsets[v + 1]; a++)
+            if (!used[a]) walk(v, a, isKept, used);
+    }
+    // what is left are rings of vertices with two neighbours, each ring keeps one of them
+    for (int v = 0; v < n; v++) {
+        if (isKept[v] || chainOf[v] != -1) continue;
+        isKept[v] = 1;
+        for (int a = net.offsets[v]; a < net.offsets[v + 1]; a++)
+            if (!used[a]) walk(v, a, isKept, used);
+    }
+    for (int v = 0; v < n; v++)
+        if (isKept[v]) kept.push_back(v);
+}
+
+void Contraction::walk(int start, int arc, const std::vector<char> &isKept, std::vector<char> &used) {
+    const FlowNetwork &net = *network;
+    Chain chain;
+    chain.vertices.push_back(start);
+    chain.segmentOffsets.push_back(0);
+    for (int from = start; ; ) {
+        int to = net.heads[arc];
+        for (int a = net.offsets[from]; a < net.offsets[from + 1]; a++) {
+            if (net.heads[a] != to) continue;
+            chain.arcs.push_back(a);
+            used[a] = used[net.rev[a]] = 1;
+        }
+        chain.segmentOffsets.push_back((int) chain.arcs.size());
+        chain.vertices.push_back(to);
+        if (isKept[to]) break;
+
+        chainOf[to] = (int) chains.size();
+        positionOf[to] = (int) chain.vertices.size() - 1;
+        // leave through the other neighbour
+        for (int a = net.offsets[to]; a < net.offsets[to + 1]; a++) {
+            if (net.heads[a] != from) {
+                arc = a;
+                break;
+            }
+        }
+        from = to;
+    }
+    int last = (int) chain.vertices.size() - 1;
+    chain.forward = capacity(chain, 0, last, true);
+    chain.backward = capacity(chain, 0, last, false);
+    chains.push_back(std::move(chain));
+}
+
+double Contraction::capacity(const Chain &chain, int from, int to, bool forward) const {
+    double c = INF;
+    for (int i = from; i < to; i++) {
+        double segment = 0;
+        for (int k = chain.segmentOffsets[i]; k < chain.segmentOffsets[i + 1]; k++) {
+            int a = chain.arcs[k];
+            segment += network->cap[forward ? a : network->rev[a]];
+        }
+        c = std::min(c, segment);
+        if (i > from && !network->limit.empty()) c = std::min(c, network->limit[chain.vertices[i]]);
+    }
+    return c;
+}
+
+const FlowNetwork &Contraction::getNetwork() const {
+    return *network;
+}
+
+int Contraction::getNumKept() const {
+    return (int) kept.size();
+}
+
+Contraction::Core Contraction::core(const std::vector<int> &pinned) const {
+    const FlowNetwork &net = *network;
+    std::vector<std::pair<int, int>> cuts;      // chain and position of the pinned vertices inside chains
+    for (int id : pinned) {
+        int v = net.index(id);
+        if (v != -1 && chainOf[v] != -1) cuts.emplace_back(chainOf[v], positionOf[v]);
+    }
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    Core core;
+    FlowNetwork &out = core.network;
+    auto keep = [&](int v) {
+        out.indexOf[net.ids[v]] = (int) out.ids.size();
+        out.ids.push_back(net.ids[v]);
+    };
+    for (int v : kept) keep(v);
+    for (const auto &cut : cuts) keep(chains[cut.first].vertices[cut.second]);
+    if (!net.limit.empty())
+        for (int id : out.ids) out.limit.push_back(net.limit[net.index(id)]);
+    for (int v : net.terminals) out.terminals.push_back(out.index(net.ids[v]));
+
+    // cut the chains at the pinned vertices, a piece that closes a loop carries no flow
+    struct Span {
+        int lo, hi;
+        Piece piece;
+    };
+    std::vector<Span> spans;
+    size_t next = 0;
+    for (int c = 0; c < (int) chains.size(); c++) {
+        const Chain &chain = chains[c];
+        int from = 0;
+        auto cut = [&](int to) {
+            int x = out.index(net.ids[chain.vertices[from]]), y = out.index(net.ids[chain.vertices[to]]);
+            if (x != y) spans.push_back({std::min(x, y), std::max(x, y), {c, from, to, x < y}});
+            from = to;
+        };
+        for (; next < cuts.size() && cuts[next].first == c; next++) cut(cuts[next].second);
+        cut((int) chain.vertices.size() - 1);
+    }
+    std::sort(spans.begin(), spans.end(), [](const Span &a, const Span &b) {
+        return a.lo != b.lo ? a.lo < b.lo : a.hi != b.hi ? a.hi < b.hi : a.piece.chain < b.piece.chain;
+    });
+
+    // pieces between the same two vertices share one pair of arcs
+    int k = (int) out.ids.size();
+    std::vector<int> degree(k + 1, 0);
+    for (size_t i = 0; i < spans.size(); i++) {
+        if (i > 0 && spans[i].lo == spans[i - 1].lo && spans[i].hi == spans[i - 1].hi) continue;
+        degree[spans[i].lo]++;
+        degree[spans[i].hi]++;
+    }
+    out.offsets.assign(k + 1, 0);
+    for (int v = 0; v < k; v++) out.offsets[v + 1] = out.offsets[v] + degree[v];
+    int m = out.offsets[k];
+    out.heads.assign(m, -1);
+    out.rev.assign(m, -1);
+    out.cap.assign(m, 0);
+    out.price.assign(m, -1);
+    out.edges.assign(m, nullptr);
+
+    std::vector<int> free(out.offsets.begin(), out.offsets.end() - 1);
+    for (size_t i = 0; i < spans.size(); ) {
+        int lo = spans[i].lo, hi = spans[i].hi;
+        int a = free[lo]++, b = free[hi]++;
+        out.heads[a] = hi;
+        out.heads[b] = lo;
+        out.rev[a] = b;
+        out.rev[b] = a;
+        core.arcs.push_back(a);
+        core.pieceOffsets.push_back((int) core.pieces.size());
+        for (; i < spans.size() && spans[i].lo == lo && spans[i].hi == hi; i++) {
+            const Piece &piece = spans[i].piece;
+            const Chain &chain = chains[piece.chain];
+            bool whole = piece.from == 0 && piece.to == (int) chain.vertices.size() - 1;
+            double forward = whole ? chain.forward : capacity(chain, piece.from, piece.to, true);
+            double backward = whole ? chain.backward : capacity(chain, piece.from, piece.to, false);
+            out.cap[a] += piece.forward ? forward : backward;
+            out.cap[b] += piece.forward ? backward : forward;
+            core.pieces.push_back(piece);
+        }
+        // the core has no prices, cheapest routes need the full network
+        out.price[a] = out.cap[a] > 0 ? 0 : -1;
+        out.price[b] = out.cap[b] > 0 ? 0 : -1;
+    }
+    core.pieceOffsets.push_back((int) core.pieces.size());
+    return core;
+}
+
+void Contraction::expand(const Core &core, const FlowScratch &coreScratch, FlowScratch &scratch) const {
+    const FlowNetwork &net = *network;
+    scratch.prepare(net);
+    std::fill(scratch.flow.begin(), scratch.flow.end(), 0);
+    for (size_t p = 0; p < core.arcs.size(); p++) {
+        double f = coreScratch.flow[core.arcs[p]];
+        bool up = f > 0;
+        f = std::fabs(f);
+        for (int i = core.pieceOffsets[p]; i < core.pieceOffsets[p + 1] && f > 0; i++) {
+            const Piece &piece = core.pieces[i];
+            const Chain &chain = chains[piece.chain];
+            bool forward = piece.forward == up;
+            double x = std::min(f, capacity(chain, piece.from, piece.to, forward));
+            f -= x;
+            for (int s = piece.from; s < piece.to; s++) {
+                double y = x;
+                for (int k = chain.segmentOffsets[s]; k < chain.segmentOffsets[s + 1] && y > 0; k++) {
+                    int a = forward ? chain.arcs[k] : net.rev[chain.arcs[k]];
+                    double z = std::min(y, net.cap[a]);
+                    scratch.flow[a] += z;
+                    scratch.flow[net.rev[a]] -= z;
+                    y -= z;
+                }
+            }
+        }
+    }
+}
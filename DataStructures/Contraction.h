@@ -0,0 +1,77 @@
+/*
+ * Contraction.h
+ * Series-parallel reduction of a FlowNetwork for the max-flow algorithms.
+ *
+ * Most stations lie along lines, with exactly two neighbours. Between the vertices that are kept (junctions, terminals
+ * and the stations a query is about) such a chain of vertices behaves like one pair of arcs whose capacity is the
+ * smallest along it, the limits of its inner stations included, and chains or parallel edges that join the same two vertices add up. The core network of the
+ * kept vertices has the same maximum flows between kept vertices and the same terminals, in a fraction of the size,
+ * and the flows found on it can be spread back onto the arcs of the full network.
+ */
+
+#ifndef DA_TP_CLASSES_CONTRACTION
+#define DA_TP_CLASSES_CONTRACTION
+
+#include <memory>
+#include <vector>
+#include "FlowNetwork.h"
+
+class Contraction {
+public:
+    /*
+     * Part of a chain, from its vertex at position from to its vertex at position to.
+     */
+    struct Piece {
+        int chain, from, to;
+        bool forward;       // the piece runs from the first to the second vertex of its arc pair
+    };
+
+    /*
+     * Network of the kept vertices, with the pieces each of its arc pairs stands for.
+     */
+    struct Core {
+        FlowNetwork network;
+        std::vector<int> arcs;              // arc of each pair, from its smaller to its larger vertex
+        std::vector<int> pieceOffsets;      // pieces of pair p are pieceOffsets[p] .. pieceOffsets[p + 1] - 1
+        std::vector<Piece> pieces;
+    };
+
+    /*
+     * Finds the chains of a network, which must not change while the contraction exists. Complexity O(|V|+|E|).
+     */
+    explicit Contraction(std::shared_ptr<const FlowNetwork> network);
+
+    const FlowNetwork &getNetwork() const;
+    int getNumKept() const;
+
+    /*
+     * Builds the core network that also keeps the vertices of pinned (by id), ids that do not exist are ignored.
+     * Complexity O(k + c + l) for k kept vertices, c chains and l vertices on the chains of the pinned vertices.
+     */
+    Core core(const std::vector<int> &pinned) const;
+
+    /*
+     * Spreads the flows of a core, computed in coreScratch, onto the arcs of the full network in scratch:
+     * the flow of an arc pair fills the pieces it stands for one after the other, and every segment of a piece
+     * fills its parallel arcs one after the other. Complexity O(|E|).
+     */
+    void expand(const Core &core, const FlowScratch &coreScratch, FlowScratch &scratch) const;
+
+private:
+    struct Chain {
+        std::vector<int> vertices;          // from a kept vertex to a kept vertex, the others have two neighbours
+        std::vector<int> segmentOffsets;    // arcs from vertex i to vertex i + 1 are arcs[segmentOffsets[i] .. segmentOffsets[i + 1] - 1]
+        std::vector<int> arcs;
+        double forward, backward;           // capacity of the whole chain in each direction
+    };
+
+    std::shared_ptr<const FlowNetwork> network;
+    std::vector<int> kept;                  // positions of the kept vertices
+    std::vector<Chain> chains;
+    std::vector<int> chainOf, positionOf;   // chain and position of each vertex inside one, -1 for kept vertices
+
+    void walk(int start, int arc, const std::vector<char> &isKept, std::vector<char> &used);
+    double capacity(const Chain &chain, int from, int to, bool forward) const;
+};
+
+#endif /* DA_TP_CLASSES_CONTRACTION */
@@ -0,0 +1,170 @@
+/*
+ * FailureConnectivity.cpp
+ */
+
+#include <algorithm>
+#include "FailureConnectivity.h"
+#include "UFDS.h"
+
+FailureConnectivity::Rollback::Rollback(int n) : path((size_t) n), size((size_t) n, 1) {
+    for (int i = 0; i < n; i++) path[i] = i;
+}
+
+int FailureConnectivity::Rollback::find(int x) const {
+    // no path compression, so every join can be undone
+    while (path[x] != x) x = path[x];
+    return x;
+}
+
+void FailureConnectivity::Rollback::join(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    if (size[a] < size[b]) std::swap(a, b);
+    path[b] = a;
+    size[a] += size[b];
+    joined.push_back(b);
+}
+
+void FailureConnectivity::Rollback::undo(size_t to) {
+    while (joined.size() > to) {
+        int b = joined.back();
+        joined.pop_back();
+        size[path[b]] -= size[b];
+        path[b] = b;
+    }
+}
+
+FailureConnectivity::FailureConnectivity(const FlowNetwork &network, const std::vector<std::pair<int, int>> &edges,
+                                         const std::vector<std::vector<int>> &scenarios)
+        : network(network), numScenarios(scenarios.size()) {
+    int n = network.getNumVertex();
+    std::vector<std::pair<int, int>> ends;                  // positions of the vertices each edge joins, -1 if one does not exist
+    for (const auto &e : edges) ends.emplace_back(network.index(e.first), network.index(e.second));
+
+    // scenarios where each edge fails, in order
+    std::vector<std::vector<int>> fails(ends.size());
+    for (size_t s = 0; s < scenarios.size(); s++)
+        for (int j : scenarios[s])
+            if (fails[j].empty() || fails[j].back() != (int) s) fails[j].push_back((int) s);
+
+    UFDS base((unsigned int) n), whole((unsigned int) n);
+    for (size_t j = 0; j < ends.size(); j++) {
+        auto e = ends[j];
+        if (e.first == -1 || e.second == -1) continue;
+        whole.linkSets(e.first, e.second);
+        if (fails[j].empty()) base.linkSets(e.first, e.second);
+    }
+    std::vector<int> groupOfRoot((size_t) n, -1), wholeOfRoot((size_t) n, -1);
+    int parts = 0;
+    groupOf.resize((size_t) n);
+    wholeOf.resize((size_t) n);
+    for (int v = 0; v < n; v++) {
+        int &g = groupOfRoot[base.findSet(v)], &w = wholeOfRoot[whole.findSet(v)];
+        if (g == -1) g = groups++;
+        if (w == -1) w = parts++;
+        groupOf[v] = g;
+        wholeOf[v] = w;
+    }
+    components.assign(numScenarios * groups, -1);
+    if (scenarios.empty()) return;
+
+    // every run of scenarios where an edge is up, on the nodes of a segment tree over the scenarios that cover it
+    int width = 1;
+    while (width < (int) scenarios.size()) width *= 2;
+    std::vector<std::pair<int, std::pair<int, int>>> laid;     // (node, groups joined)
+    auto lay = [&](int from, int to, std::pair<int, int> link) {
+        for (from += width, to += width + 1; from < to; from /= 2, to /= 2) {
+            if (from & 1) laid.emplace_back(from++, link);
+            if (to & 1) laid.emplace_back(--to, link);
+        }
+    };
+    int last = (int) scenarios.size() - 1;
+    for (size_t j = 0; j < ends.size(); j++) {
+        auto e = ends[j];
+        if (fails[j].empty() || e.first == -1 || e.second == -1) continue;
+        std::pair<int, int> link(groupOf[e.first], groupOf[e.second]);
+        if (link.first == link.second) continue;
+        int from = 0;
+        for (int s : fails[j]) {
+            if (from < s) lay(from, s - 1, link);
+            from = s + 1;
+        }
+        if (from <= last) lay(from, last, link);
+    }
+    Tree tree;
+    tree.offsets.assign(2 * (size_t) width + 1, 0);
+    for (const auto &l : laid) tree.offsets[l.first + 1]++;
+    for (size_t i = 1; i < tree.offsets.size(); i++) tree.offsets[i] += tree.offsets[i - 1];
+    tree.links.resize(laid.size());
+    std::vector<int> next(tree.offsets.begin(), tree.offsets.end() - 1);
+    for (const auto &l : laid) tree.links[next[l.first]++] = l.second;
+
+    Rollback sets(groups);
+    walk(1, 0, width - 1, tree, sets);
+}
+
+void FailureConnectivity::walk(int node, int lo, int hi, const Tree &tree, Rollback &sets) {
+    if (lo >= (int) numScenarios) return;
+    size_t mark = sets.joined.size();
+    for (int i = tree.offsets[node]; i < tree.offsets[node + 1]; i++) sets.join(tree.links[i].first, tree.links[i].second);
+    if (lo == hi) {
+        // every group is labelled once, with the label of the first labelled group above it
+        int *component = components.data() + (size_t) lo * groups;
+        for (int g = 0; g < groups; g++) {
+            int x = g;
+            while (component[x] == -1 && sets.path[x] != x) x = sets.path[x];
+            int root = component[x] == -1 ? x : component[x];
+            for (x = g; component[x] == -1; x = sets.path[x]) component[x] = root;
+        }
+    } else {
+        int mid = (lo + hi) / 2;
+        walk(2 * node, lo, mid, tree, sets);
+        walk(2 * node + 1, mid + 1, hi, tree, sets);
+    }
+    sets.undo(mark);
+}
+
+size_t FailureConnectivity::getNumScenarios() const {
+    return numScenarios;
+}
+
+bool FailureConnectivity::connected(size_t scenario, int u, int v) const {
+    const int *component = components.data() + scenario * groups;
+    return component[groupOf[u]] == component[groupOf[v]];
+}
+
+std::vector<std::vector<int>> FailureConnectivity::islands(size_t scenario) const {
+    const int *component = components.data() + scenario * groups;
+    int n = network.getNumVertex();
+    std::vector<int> pieceOf((size_t) n), size((size_t) groups, 0), least((size_t) groups, -1);
+    for (int v = 0; v < n; v++) {
+        int piece = pieceOf[v] = component[groupOf[v]];
+        size[piece]++;
+        if (least[piece] == -1 || network.id(v) < least[piece]) least[piece] = network.id(v);
+    }
+
+    // the largest piece of every part of the network stays (ties by smallest id), the other pieces are cut off
+    std::vector<int> main((size_t) n, -1);                 // part of the network -> the piece that stays
+    for (int v = 0; v < n; v++) {
+        int &stays = main[wholeOf[v]], piece = pieceOf[v];
+        if (stays == -1 || size[piece] > size[stays] || (size[piece] == size[stays] && least[piece] < least[stays]))
+            stays = piece;
+    }
+    std::vector<int> group((size_t) groups, -1);          // piece cut off -> its island
+    std::vector<std::vector<int>> cut;
+    for (int v = 0; v < n; v++) {
+        int piece = pieceOf[v];
+        if (main[wholeOf[v]] == piece) continue;
+        if (group[piece] == -1) {
+            group[piece] = (int) cut.size();
+            cut.emplace_back();
+        }
+        cut[group[piece]].push_back(network.id(v));
+    }
+    for (auto &island : cut) std::sort(island.begin(), island.end());
+    std::sort(cut.begin(), cut.end(), [](const std::vector<int> &a, const std::vector<int> &b) {
+        return a.size() != b.size() ? a.size() > b.size() : a.front() < b.front();
+    });
+    return cut;
+}
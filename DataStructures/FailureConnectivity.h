@@ -0,0 +1,75 @@
+/*
+ * FailureConnectivity.h
+ * Which vertices of a FlowNetwork stay connected in many failure scenarios, each a set of failed edges, answered offline.
+ *
+ * The edges that fail in no scenario are joined once, in a base union-find, and the vertices of each of its sets become one
+ * group. An edge that fails in some scenarios is up in the runs of scenarios between its failures, and every run is laid
+ * on a segment tree over the scenarios. A depth-first walk of the tree joins the edges of each node on the way down in a
+ * union-find of the groups without path compression, and undoes them on the way back up, so at every leaf it holds
+ * the connectivity of that scenario. With many scenarios almost every edge fails in one of them, but each edge is still
+ * joined only O(r*log(n)) times for its r runs and n scenarios, instead of once per scenario.
+ */
+
+#ifndef DA_TP_CLASSES_FAILURECONNECTIVITY
+#define DA_TP_CLASSES_FAILURECONNECTIVITY
+
+#include <utility>
+#include <vector>
+#include "FlowNetwork.h"
+
+class FailureConnectivity {
+public:
+    /*
+     * Finds the connectivity of every scenario, given as positions in a list of edges, each edge the ids of the vertices
+     * it joins. Complexity O(|V| + s + (t + f)*log(n)*log(|V|) + n*g) for s edges, t of them failing in some scenario,
+     * f failures over the n scenarios and g groups.
+     */
+    FailureConnectivity(const FlowNetwork &network, const std::vector<std::pair<int, int>> &edges,
+                        const std::vector<std::vector<int>> &scenarios);
+
+    size_t getNumScenarios() const;
+
+    /*
+     * Whether two vertices (by position in the network) are connected in a scenario. Complexity O(1).
+     */
+    bool connected(size_t scenario, int u, int v) const;
+
+    /*
+     * Groups of vertices (by id) that a scenario cuts off from the largest part of what was connected to them (of parts
+     * as large, the one with the smallest id), largest group first (ties by smallest id). Complexity O(|V|*log(|V|)).
+     */
+    std::vector<std::vector<int>> islands(size_t scenario) const;
+
+private:
+    const FlowNetwork &network;
+    std::vector<int> groupOf;                   // group of each vertex, its set with the edges that never fail
+    std::vector<int> wholeOf;                   // set of each vertex with every edge
+    size_t numScenarios;
+    int groups = 0;                             // number of groups
+    std::vector<int> components;                // set of each group in each scenario, scenario s from s*groups
+
+    /*
+     * Union-find of the groups that can undo its last joins.
+     */
+    struct Rollback {
+        std::vector<int> path, size;
+        std::vector<int> joined;                // roots put under another root, last first undone
+
+        explicit Rollback(int n);
+        int find(int x) const;
+        void join(int a, int b);
+        void undo(size_t to);
+    };
+
+    /*
+     * Groups joined at each node of the segment tree, node i from links[offsets[i]] to links[offsets[i + 1]].
+     */
+    struct Tree {
+        std::vector<int> offsets;
+        std::vector<std::pair<int, int>> links;
+    };
+
+    void walk(int node, int lo, int hi, const Tree &tree, Rollback &sets);
+};
+
+#endif /* DA_TP_CLASSES_FAILURECONNECTIVITY */
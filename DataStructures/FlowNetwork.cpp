@@ -0,0 +1,601 @@
+/*
+ * FlowNetwork.cpp
+ */
+
+#include "FlowNetwork.h"
+#include "GraphStats.h"
+
+bool FlowScratch::close(const FlowNetwork &network, int id1, int id2) {
+    int u = network.index(id1), v = network.index(id2);
+    if (u == -1 || v == -1) return false;
+    prepare(network);
+    bool found = false;
+    for (int a = network.offsets[u]; a < network.offsets[u + 1]; a++) {
+        if (network.heads[a] == v) {
+            for (int b : {a, network.rev[a]}) {
+                if (!closed[b]) closedArcs.push_back(b);
+                closed[b] = 1;
+            }
+            found = true;
+        }
+    }
+    return found;
+}
+
+void FlowScratch::open() {
+    for (int a : closedArcs) closed[a] = 0;
+    closedArcs.clear();
+}
+
+void FlowScratch::prepare(const FlowNetwork &network) {
+    size_t n = network.ids.size(), m = network.heads.size();
+    if (flow.size() != m) {
+        flow.assign(m, 0);
+        closed.assign(m, 0);
+        closedArcs.clear();
+    }
+    if (!network.limit.empty() && from.size() != 2 * n) {
+        from.assign(2 * n, -1);
+        through.assign(n, 0);
+    }
+    if (parent.size() != n) {
+        parent.assign(n, -1);
+        onPath.assign(n, -1);
+        target.assign(n, 0);
+        visited.assign((n + 63) / 64, 0);
+        frontier.assign((n + 63) / 64, 0);
+        next.assign((n + 63) / 64, 0);
+        cost.assign(n, INF);
+        trains.assign(n, 0);
+    }
+}
+
+FlowNetwork::FlowNetwork(const Graph &graph) {
+    auto vertexSet = graph.getVertexSet();
+    int n = (int) vertexSet.size();
+    ids.resize(n);
+    for (int v = 0; v < n; v++) {
+        ids[v] = vertexSet[v]->getId();
+        indexOf[ids[v]] = v;
+        if (vertexSet[v]->getCapacity() == INF) continue;
+        if (limit.empty()) limit.assign(n, INF);
+        limit[v] = vertexSet[v]->getCapacity();
+    }
+
+    // a one way edge also needs an arc leaving its destination, to push its flow back
+    std::vector<int> degree(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        for (auto e : vertexSet[v]->getAdj()) {
+            degree[v]++;
+            if (e->getReverse() == nullptr) degree[indexOf[e->getDest()->getId()]]++;
+        }
+        if (vertexSet[v]->getAdj().size() == 1) terminals.push_back(v);
+    }
+    offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) offsets[v + 1] = offsets[v] + degree[v];
+
+    int m = offsets[n];
+    heads.assign(m, -1);
+    rev.assign(m, -1);
+    cap.assign(m, 0);
+    price.assign(m, -1);
+    edges.assign(m, nullptr);
+    service.assign(m, ALL_SERVICES);
+
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    std::unordered_map<const Edge *, int> arcOf;
+    for (int v = 0; v < n; v++) {
+        for (auto e : vertexSet[v]->getAdj()) {
+            int w = indexOf[e->getDest()->getId()];
+            int a = next[v]++;
+            heads[a] = w;
+            cap[a] = e->getWeight();
+            price[a] = e->getPrice();
+            edges[a] = e;
+            service[a] = e->getService();
+
+            if (e->getReverse() == nullptr) {
+                int b = next[w]++;
+                heads[b] = v;
+                service[b] = e->getService();
+                rev[a] = b;
+                rev[b] = a;
+                continue;
+            }
+            auto paired = arcOf.find(e->getReverse());
+            if (paired == arcOf.end()) {
+                arcOf[e] = a;
+            }
+            else {
+                rev[a] = paired->second;
+                rev[paired->second] = a;
+            }
+        }
+    }
+}
+
+FlowNetwork::FlowNetwork(const FlowNetwork &network, unsigned int services)
+        : ids(network.ids), indexOf(network.indexOf), limit(network.limit) {
+    int n = network.getNumVertex();
+    auto keeps = [&](int a) { return network.service.empty() || (network.service[a] & services) != 0; };
+
+    // new position of each arc kept, -1 for the others
+    std::vector<int> arcOf(network.heads.size(), -1);
+    offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        int edgesLeft = 0;
+        offsets[v + 1] = offsets[v];
+        for (int a = network.offsets[v]; a < network.offsets[v + 1]; a++) {
+            if (!keeps(a)) continue;
+            arcOf[a] = offsets[v + 1]++;
+            edgesLeft += network.price[a] >= 0;
+        }
+        if (edgesLeft == 1) terminals.push_back(v);
+    }
+
+    int m = offsets[n];
+    heads.resize(m);
+    rev.resize(m);
+    cap.resize(m);
+    price.resize(m);
+    edges.resize(m);
+    if (!network.service.empty()) service.resize(m);
+    for (int a = 0; a < network.getNumArcs(); a++) {
+        int b = arcOf[a];
+        if (b == -1) continue;
+        heads[b] = network.heads[a];
+        rev[b] = arcOf[network.rev[a]];
+        cap[b] = network.cap[a];
+        price[b] = network.price[a];
+        edges[b] = network.edges[a];
+        if (!service.empty()) service[b] = network.service[a];
+    }
+}
+
+int FlowNetwork::getNumVertex() const {
+    return (int) ids.size();
+}
+
+int FlowNetwork::getNumArcs() const {
+    return (int) heads.size();
+}
+
+int FlowNetwork::index(int id) const {
+    auto it = indexOf.find(id);
+    return it == indexOf.end() ? -1 : it->second;
+}
+
+int FlowNetwork::id(int v) const {
+    return ids[v];
+}
+
+double FlowNetwork::limitOf(int id) const {
+    int v = index(id);
+    return v == -1 || limit.empty() ? INF : limit[v];
+}
+
+bool FlowNetwork::adjacent(int id1, int id2) const {
+    int u = index(id1), v = index(id2);
+    if (u == -1 || v == -1) return false;
+    for (int a = offsets[u]; a < offsets[u + 1]; a++)
+        if (heads[a] == v) return true;
+    return false;
+}
+
+std::vector<int> FlowNetwork::parts() const {
+    int n = getNumVertex();
+    std::vector<int> part(n, -1), stack;
+    for (int s = 0, count = 0; s < n; s++) {
+        if (part[s] != -1) continue;
+        part[s] = count;
+        stack.push_back(s);
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            for (int a = offsets[u]; a < offsets[u + 1]; a++) {
+                if (part[heads[a]] != -1) continue;
+                part[heads[a]] = count;
+                stack.push_back(heads[a]);
+            }
+        }
+        count++;
+    }
+    return part;
+}
+
+bool FlowNetwork::limited(int v) const {
+    return !limit.empty() && limit[v] != INF;
+}
+
+/*
+ * Bitmaps keep 64 vertices per word: clearing or swapping a frontier is a plain loop over words and
+ * finding its vertices skips a whole empty word at a time.
+ */
+static inline bool testBit(const std::vector<uint64_t> &bits, int v) {
+    return (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+static inline void setBit(std::vector<uint64_t> &bits, int v) {
+    bits[v >> 6] |= uint64_t(1) << (v & 63);
+}
+
+int FlowNetwork::search(const std::vector<int> &sources, FlowScratch &scratch) const {
+    STATS_PHASE(Phase::Search);
+    unsigned long long scanned = 0;
+    int n = getNumVertex();
+    size_t words = scratch.visited.size();
+    std::fill(scratch.visited.begin(), scratch.visited.end(), 0);
+    std::fill(scratch.frontier.begin(), scratch.frontier.end(), 0);
+
+    long frontierArcs = 0, frontierSize = 0, unexploredArcs = getNumArcs();
+    for (int s : sources) {
+        if (scratch.target[s] || testBit(scratch.visited, s)) continue;
+        setBit(scratch.visited, s);
+        setBit(scratch.frontier, s);
+        scratch.parent[s] = -1;
+        frontierSize++;
+        frontierArcs += offsets[s + 1] - offsets[s];
+    }
+    unexploredArcs -= frontierArcs;
+
+    int reached = -1;
+    bool bottomUp = false;
+    while (frontierSize > 0 && reached == -1) {
+        // switch to bottom-up when the frontier has more arcs to scan than the unvisited vertices, and back once it shrinks
+        if (!bottomUp && frontierArcs * BOTTOM_UP_FACTOR > unexploredArcs) bottomUp = true;
+        else if (bottomUp && frontierSize * TOP_DOWN_FACTOR < n) bottomUp = false;
+
+        std::fill(scratch.next.begin(), scratch.next.end(), 0);
+        long nextArcs = 0, nextSize = 0;
+        auto visit = [&](int w, int a) {
+            setBit(scratch.visited, w);
+            setBit(scratch.next, w);
+            scratch.parent[w] = a;
+            nextSize++;
+            nextArcs += offsets[w + 1] - offsets[w];
+            if (scratch.target[w]) reached = w;
+        };
+
+        if (!bottomUp) {
+            for (size_t i = 0; i < words && reached == -1; i++) {
+                for (uint64_t word = scratch.frontier[i]; word != 0 && reached == -1; word &= word - 1) {
+                    int u = (int) (i * 64 + __builtin_ctzll(word));
+                    for (int a = offsets[u]; a < offsets[u + 1]; a++) {
+                        scanned++;
+                        int w = heads[a];
+                        if (testBit(scratch.visited, w) || scratch.closed[a] || cap[a] - scratch.flow[a] <= 0) continue;
+                        visit(w, a);
+                        if (reached != -1) break;
+                    }
+                }
+            }
+        }
+        else {
+            // every arc into v is the reverse of an arc out of v
+            for (size_t i = 0; i < words && reached == -1; i++) {
+                uint64_t unvisited = ~scratch.visited[i];
+                if (i == words - 1 && n % 64 != 0) unvisited &= (uint64_t(1) << (n % 64)) - 1;
+                for (; unvisited != 0 && reached == -1; unvisited &= unvisited - 1) {
+                    int v = (int) (i * 64 + __builtin_ctzll(unvisited));
+                    for (int a = offsets[v]; a < offsets[v + 1]; a++) {
+                        scanned++;
+                        int b = rev[a];
+                        if (!testBit(scratch.frontier, heads[a]) || scratch.closed[b] || cap[b] - scratch.flow[b] <= 0) continue;
+                        visit(v, b);
+                        break;
+                    }
+                }
+            }
+        }
+
+        scratch.frontier.swap(scratch.next);
+        frontierSize = nextSize;
+        frontierArcs = nextArcs;
+        unexploredArcs -= nextArcs;
+    }
+    STATS_ADD(edgesScanned, scanned);
+    return reached;
+}
+
+double FlowNetwork::augment(const std::vector<int> &sources, const std::vector<int> &targets, FlowScratch &scratch) const {
+    scratch.prepare(*this);
+    {
+        STATS_PHASE(Phase::Reset);
+        std::fill(scratch.flow.begin(), scratch.flow.end(), 0);
+    }
+    return augmentFrom(sources, targets, scratch);
+}
+
+double FlowNetwork::augmentFrom(const std::vector<int> &sources, const std::vector<int> &targets, FlowScratch &scratch) const {
+    STATS_ADD(maxFlowRuns, 1);
+    scratch.prepare(*this);
+    for (int t : targets) scratch.target[t] = 1;
+
+    double total = 0;
+    if (!limit.empty()) {
+        // the flow through every vertex, from the flow it starts with
+        std::fill(scratch.through.begin(), scratch.through.end(), 0);
+        for (int a = 0; a < getNumArcs(); a++)
+            if (scratch.flow[a] > 0) scratch.through[heads[rev[a]]] += scratch.flow[a];
+
+        for (int state = searchSplit(sources, scratch); state != -1; state = searchSplit(sources, scratch)) {
+            STATS_PHASE(Phase::Augment);
+            STATS_ADD(augmentingPaths, 1);
+            double f = INF;
+            int previous;
+            for (int x = state; scratch.from[x] != START; x = previous) f = std::min(f, room(x, scratch, previous));
+            for (int x = state; scratch.from[x] != START; x = previous) {
+                room(x, scratch, previous);
+                if (scratch.from[x] == INSIDE) continue;
+                // the flow through each end is its flow out, which the arc changes from before to after
+                int a = scratch.from[x] / 3;
+                double before = scratch.flow[a], after = before + f;
+                scratch.flow[a] = after;
+                scratch.flow[rev[a]] = -after;
+                scratch.through[heads[rev[a]]] += std::max(0.0, after) - std::max(0.0, before);
+                scratch.through[heads[a]] += std::max(0.0, -after) - std::max(0.0, -before);
+            }
+            total += f;
+        }
+        for (int t : targets) scratch.target[t] = 0;
+        return total;
+    }
+    for (int target = search(sources, scratch); target != -1; target = search(sources, scratch)) {
+        STATS_PHASE(Phase::Augment);
+        STATS_ADD(augmentingPaths, 1);
+        double f = INF;
+        for (int v = target; scratch.parent[v] != -1; v = heads[rev[scratch.parent[v]]]) {
+            int a = scratch.parent[v];
+            f = std::min(f, cap[a] - scratch.flow[a]);
+        }
+        for (int v = target; scratch.parent[v] != -1; v = heads[rev[scratch.parent[v]]]) {
+            int a = scratch.parent[v];
+            scratch.flow[a] += f;
+            scratch.flow[rev[a]] -= f;
+        }
+        total += f;
+    }
+    for (int t : targets) scratch.target[t] = 0;
+    return total;
+}
+
+int FlowNetwork::searchSplit(const std::vector<int> &sources, FlowScratch &scratch) const {
+    STATS_PHASE(Phase::Search);
+    unsigned long long scanned = 0;
+    int n = getNumVertex();
+    auto &from = scratch.from;
+    auto &queue = scratch.queue;
+    std::fill(from.begin(), from.end(), -1);
+    queue.clear();
+    // a source is not limited, it starts from its entrance and its exit
+    for (int s : sources) {
+        if (scratch.target[s] || from[2 * s] != -1) continue;
+        from[2 * s] = START;
+        queue.push_back(2 * s);
+        if (!limited(s)) continue;
+        from[2 * s + 1] = START;
+        queue.push_back(2 * s + 1);
+    }
+
+    int reached = -1;
+    auto visit = [&](int x, int move) {
+        if (from[x] != -1) return;
+        from[x] = move;
+        queue.push_back(x);
+        if (scratch.target[x >> 1]) reached = x;
+    };
+    for (size_t i = 0; i < queue.size() && reached == -1; i++) {
+        int x = queue[i], v = x >> 1;
+        bool entrance = !limited(v) || x % 2 == 0, exit = !limited(v) || x % 2 == 1;
+        if (limited(v)) {
+            if (entrance && scratch.through[v] < limit[v]) visit(2 * v + 1, INSIDE);
+            if (exit && scratch.through[v] > 0) visit(2 * v, INSIDE);
+        }
+        for (int a = offsets[v]; a < offsets[v + 1] && reached == -1; a++) {
+            scanned++;
+            if (scratch.closed[a]) continue;
+            int w = heads[a];
+            double flow = scratch.flow[a];
+            if (!limited(v) && !limited(w)) {
+                if (cap[a] - flow > 0) visit(2 * w, 3 * a + BOTH);
+                continue;
+            }
+            if (exit && cap[a] - std::max(0.0, flow) > 0) visit(2 * w, 3 * a + FRESH);
+            if (entrance && flow < 0) visit(limited(w) ? 2 * w + 1 : 2 * w, 3 * a + UNDO);
+        }
+    }
+
+    // the vertices every state of which was reached, like the vertices search reaches
+    std::fill(scratch.visited.begin(), scratch.visited.end(), 0);
+    for (int v = 0; v < n; v++)
+        if (from[2 * v] != -1 && (!limited(v) || from[2 * v + 1] != -1)) setBit(scratch.visited, v);
+    STATS_ADD(edgesScanned, scanned);
+    return reached;
+}
+
+double FlowNetwork::room(int state, const FlowScratch &scratch, int &previous) const {
+    int move = scratch.from[state], v = state >> 1;
+    if (move == INSIDE) {
+        previous = state ^ 1;
+        return state % 2 == 1 ? limit[v] - scratch.through[v] : scratch.through[v];
+    }
+    int a = move / 3, u = heads[rev[a]];
+    double flow = scratch.flow[a];
+    if (move % 3 == FRESH) {
+        previous = limited(u) ? 2 * u + 1 : 2 * u;
+        return cap[a] - std::max(0.0, flow);
+    }
+    previous = 2 * u;
+    return move % 3 == UNDO ? -flow : cap[a] - flow;
+}
+
+void FlowNetwork::storeFlows(const FlowScratch &scratch) const {
+    for (int a = 0; a < getNumArcs(); a++) {
+        if (edges[a] != nullptr) edges[a]->setFlow(std::max(0.0, scratch.flow[a]));
+    }
+}
+
+void FlowNetwork::loadFlows(FlowScratch &scratch) const {
+    scratch.prepare(*this);
+    std::fill(scratch.flow.begin(), scratch.flow.end(), 0);
+    for (int a = 0; a < getNumArcs(); a++) {
+        if (edges[a] == nullptr) continue;
+        scratch.flow[a] += edges[a]->getFlow();
+        scratch.flow[rev[a]] -= edges[a]->getFlow();
+    }
+}
+
+void FlowNetwork::decompose(int source, int target, FlowScratch &scratch, std::vector<std::vector<int>> &paths,
+                            std::vector<double> &amounts) const {
+    paths.clear();
+    amounts.clear();
+    int s = index(source), t = index(target);
+    if (s == -1 || t == -1 || s == t) return;
+    scratch.prepare(*this);
+    auto &next = scratch.parent;    // next arc of each vertex that may still carry flow
+    for (int v = 0; v < getNumVertex(); v++) next[v] = offsets[v];
+
+    std::vector<int> vertices = {s}, arcs;
+    scratch.onPath[s] = 0;
+    // takes f off the arcs of the walk from position from on, and walks back to the vertex there
+    auto cancel = [&](size_t from, double f) {
+        for (size_t i = from; i < arcs.size(); i++) {
+            scratch.flow[arcs[i]] -= f;
+            scratch.flow[rev[arcs[i]]] += f;
+        }
+        for (size_t i = from + 1; i < vertices.size(); i++) scratch.onPath[vertices[i]] = -1;
+        vertices.resize(from + 1);
+        arcs.resize(from);
+    };
+    auto smallest = [&](size_t from) {
+        double f = INF;
+        for (size_t i = from; i < arcs.size(); i++) f = std::min(f, scratch.flow[arcs[i]]);
+        return f;
+    };
+
+    while (true) {
+        int v = vertices.back();
+        if (v == t) {
+            double f = smallest(0);
+            std::vector<int> path;
+            for (int w : vertices) path.push_back(ids[w]);
+            paths.push_back(std::move(path));
+            amounts.push_back(f);
+            cancel(0, f);
+            continue;
+        }
+        while (next[v] < offsets[v + 1] && scratch.flow[next[v]] <= 0) next[v]++;
+        if (next[v] == offsets[v + 1]) {
+            if (v == s) break;
+            // flow that goes nowhere, only left by a flow that is not conserved: drop the arc into v
+            double f = scratch.flow[arcs.back()];
+            cancel(arcs.size() - 1, f);
+            continue;
+        }
+        int a = next[v], w = heads[a];
+        arcs.push_back(a);
+        if (scratch.onPath[w] != -1) {
+            size_t from = (size_t) scratch.onPath[w];
+            cancel(from, smallest(from));
+            continue;
+        }
+        scratch.onPath[w] = (int) vertices.size();
+        vertices.push_back(w);
+    }
+    scratch.onPath[s] = -1;
+}
+
+double FlowNetwork::maxFlow(int source, int target, FlowScratch &scratch) const {
+    int s = index(source), t = index(target);
+    if (s == -1 || t == -1 || s == t) return 0;
+    return augment({s}, {t}, scratch);
+}
+
+double FlowNetwork::resumeMaxFlow(int source, int target, FlowScratch &scratch) const {
+    int s = index(source), t = index(target);
+    if (s == -1 || t == -1 || s == t) return 0;
+    return augmentFrom({s}, {t}, scratch);
+}
+
+double FlowNetwork::arrivals(int station, FlowScratch &scratch) const {
+    int t = index(station);
+    if (t == -1) return 0;
+    return augment(openTerminals(scratch), {t}, scratch);
+}
+
+double FlowNetwork::inflow(const std::vector<int> &members, FlowScratch &scratch) const {
+    std::vector<int> targets;
+    for (int id : members) {
+        int v = index(id);
+        if (v != -1) targets.push_back(v);
+    }
+    if (targets.empty()) return 0;
+    return augment(openTerminals(scratch), targets, scratch);
+}
+
+const std::vector<int> &FlowNetwork::openTerminals(FlowScratch &scratch) const {
+    if (scratch.closedArcs.empty()) return terminals;
+
+    // closing arcs turns more vertices into terminals
+    scratch.sources.clear();
+    for (int v = 0; v < getNumVertex(); v++) {
+        int open = 0;
+        for (int a = offsets[v]; a < offsets[v + 1]; a++) open += price[a] >= 0 && !scratch.closed[a];
+        if (open == 1) scratch.sources.push_back(v);
+    }
+    return scratch.sources;
+}
+
+void FlowNetwork::cheapest(int source, int target, FlowScratch &scratch, std::vector<int> &path, double &trains, double &cost) const {
+    STATS_PHASE(Phase::Dijkstra);
+    path.clear();
+    trains = cost = 0;
+    int s = index(source), t = index(target);
+    if (s == -1 || t == -1) return;
+
+    scratch.prepare(*this);
+    std::fill(scratch.cost.begin(), scratch.cost.end(), INF);
+    std::fill(scratch.trains.begin(), scratch.trains.end(), 0);
+    std::fill(scratch.parent.begin(), scratch.parent.end(), -1);
+
+    unsigned long long pushes = 0, pops = 0, scanned = 0;
+    auto &heap = scratch.heap;
+    auto later = [](const std::pair<double, int> &a, const std::pair<double, int> &b) { return a > b; };
+    heap.clear();
+    scratch.cost[s] = 0;
+    heap.emplace_back(0, s);
+    pushes++;
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        auto top = heap.back();
+        heap.pop_back();
+        pops++;
+        int u = top.second;
+        if (top.first > scratch.cost[u]) continue;
+        if (u == t) break;
+        for (int a = offsets[u]; a < offsets[u + 1]; a++) {
+            scanned++;
+            if (price[a] < 0 || scratch.closed[a]) continue;
+            int w = heads[a];
+            double c = scratch.cost[u] + cap[a] * price[a];
+            if (c < scratch.cost[w]) {
+                scratch.cost[w] = c;
+                scratch.trains[w] = scratch.trains[u] + cap[a];
+                scratch.parent[w] = a;
+                heap.emplace_back(c, w);
+                std::push_heap(heap.begin(), heap.end(), later);
+                pushes++;
+            }
+        }
+    }
+    STATS_ADD(heapPushes, pushes);
+    STATS_ADD(heapPops, pops);
+    STATS_ADD(edgesScanned, scanned);
+
+    if (scratch.cost[t] == INF) return;
+    trains = scratch.trains[t];
+    cost = scratch.cost[t];
+    for (int v = t; v != s; v = heads[rev[scratch.parent[v]]]) path.push_back(ids[v]);
+    path.push_back(source);
+    std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,210 @@
+/*
+ * FlowNetwork.h
+ * Read-only, flat copy of a Graph for the flow and route algorithms.
+ *
+ * The arcs are stored in compressed rows (the arcs leaving vertex v are offsets[v] .. offsets[v + 1] - 1)
+ * and every arc has a paired reverse arc, so a residual graph needs no pointers and no copies of adjacency lists.
+ * Nothing in the network changes while a query runs: flows, visited marks and paths live in a FlowScratch,
+ * so any number of threads can query one network, each with its own scratch. Every arc keeps the service of its edge,
+ * so a network can be copied with the arcs of some services only, for the queries that keep to them.
+ *
+ * A vertex can limit the flow that passes through it. It then counts as two, an entrance where its arcs arrive and an exit
+ * where they leave, joined by an arc as wide as the limit, but the split is virtual: the searches reach the entrance or
+ * the exit of a vertex (state 2v or 2v + 1) and work out the arcs between them from the flow through it, so the network
+ * keeps one copy of every vertex and arc. Sources and targets are never limited. A network without limits never splits.
+ */
+
+#ifndef DA_TP_CLASSES_FLOWNETWORK
+#define DA_TP_CLASSES_FLOWNETWORK
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Graph.h"
+
+class FlowNetwork;
+
+/*
+ * Per-thread working memory of the FlowNetwork algorithms. It is sized on first use and reused afterwards.
+ */
+class FlowScratch {
+public:
+    /*
+     * Marks every arc between two vertices (given by id), in both directions, as closed until open() is called.
+     * Returns false if there is no such arc.
+     */
+    bool close(const FlowNetwork &network, int id1, int id2);
+    /*
+     * Reopens every closed arc.
+     */
+    void open();
+
+private:
+    friend class FlowNetwork;
+    friend class Contraction;
+    friend class ArrivalsIndex;
+    friend class CapacitySensitivity;
+    void prepare(const FlowNetwork &network);
+
+    std::vector<double> flow;       // flow of each arc, flow[rev[a]] == -flow[a]
+    std::vector<int> parent;        // arc through which each vertex was reached, -1 for none
+    std::vector<int> from;          // move through which each vertex state was reached, see searchSplit
+    std::vector<double> through;    // flow through each vertex, for networks with limits
+    std::vector<int> queue;
+    std::vector<int> onPath;        // position of each vertex on the path being followed, -1 if it is not on it
+    std::vector<char> target;       // vertices the flow goes to
+    std::vector<uint64_t> visited, frontier, next;    // bitmaps of the vertices, 64 per word
+    std::vector<char> closed;       // arcs left out of every search
+    std::vector<int> closedArcs;    // the arcs marked in closed
+    std::vector<int> sources;
+    std::vector<double> cost, trains;
+    std::vector<std::pair<double, int>> heap;
+};
+
+class FlowNetwork {
+public:
+    FlowNetwork() = default;
+    /*
+     * Copies the vertices and edges of a graph. Two edges that are each other's reverse share one pair of arcs.
+     */
+    explicit FlowNetwork(const Graph &graph);
+    /*
+     * Copies a network with only the arcs whose service is one of the bits of services. Every vertex keeps its position,
+     * and a vertex left with a single edge becomes a terminal. Complexity O(|V|+|E|)
+     */
+    FlowNetwork(const FlowNetwork &network, unsigned int services);
+
+    int getNumVertex() const;
+    int getNumArcs() const;
+    /*
+     * Position of the vertex with a given id, or -1 if there is none.
+     */
+    int index(int id) const;
+    int id(int v) const;
+    /*
+     * Most flow that can pass through a vertex (by id), INF if it has no limit.
+     */
+    double limitOf(int id) const;
+    /*
+     * Whether an arc joins two vertices (by id). Complexity O(d) for the degree of the first.
+     */
+    bool adjacent(int id1, int id2) const;
+    /*
+     * Connected part of each vertex (by position), numbered from 0 in the order of their first vertex. Complexity O(|V|+|E|)
+     */
+    std::vector<int> parts() const;
+
+    /** Edmonds-Karp between two vertices (by id), on the open arcs
+     * @return Value of the maximum flow, 0 if a vertex does not exist
+     * @brief Complexity O(|V|*|E|^2)
+     */
+    double maxFlow(int source, int target, FlowScratch &scratch) const;
+
+    /** Edmonds-Karp between two vertices (by id) that carries on from the flow already in scratch instead of starting
+     * from none, e.g. a max flow of the same network before some arcs were widened
+     * @return Flow added to the one in scratch
+     * @brief Complexity O(|V|*|E|*p) for p augmenting paths added
+     */
+    double resumeMaxFlow(int source, int target, FlowScratch &scratch) const;
+
+    /** Maximum flow into a vertex (by id) from every terminal vertex (a vertex with a single open edge) other than itself,
+     * as if a super source fed the terminals through edges of unlimited capacity
+     * @brief Complexity O(|V|*|E|^2)
+     */
+    double arrivals(int station, FlowScratch &scratch) const;
+
+    /** Maximum flow into a group of vertices (by id), as if a super sink drained them, from every terminal vertex
+     * outside the group, as if a super source fed them
+     * @brief Complexity O(|V|*|E|^2)
+     */
+    double inflow(const std::vector<int> &members, FlowScratch &scratch) const;
+
+    /** Dijkstra on the cost (capacity * price) of the edges, from source to target (by id), on the open arcs
+     * @param path Ids of the vertices along the cheapest path, empty if the target cannot be reached
+     * @param trains Sum of the capacities along the path
+     * @param cost Cost of the path
+     * @brief Complexity O((|V|+|E|)*log(|E|))
+     */
+    void cheapest(int source, int target, FlowScratch &scratch, std::vector<int> &path, double &trains, double &cost) const;
+
+    /*
+     * Sets the flow of each edge of the graph to the flow its arc carries in scratch, 0 if it carries flow the other way.
+     */
+    void storeFlows(const FlowScratch &scratch) const;
+    /*
+     * Sets the flow in scratch to the flows of the edges of the graph, the reverse of storeFlows.
+     */
+    void loadFlows(FlowScratch &scratch) const;
+
+    /** Splits the flow in scratch from source to target (by id) into paths, each with the flow it carries, and cancels
+     * the cycles met on the way. Each vertex keeps a pointer to its next arc with flow left, so arcs used up are never
+     * scanned again and no search is repeated. The flow in scratch is used up
+     * @param paths Ids of the vertices along each path, from source to target
+     * @param amounts Flow carried by each path
+     * @brief Complexity O(|E| + (p+c)*|V|) for p paths and c cycles
+     */
+    void decompose(int source, int target, FlowScratch &scratch, std::vector<std::vector<int>> &paths,
+                   std::vector<double> &amounts) const;
+
+private:
+    friend class FlowScratch;
+    friend class Contraction;
+    friend class BlockCutTree;
+    friend class ArrivalsIndex;
+    friend class CapacitySensitivity;
+    friend class GlobalMinCut;
+    friend class WidestPaths;
+    /*
+     * Breadth-first search for a shortest augmenting path from any source to any target, on bitmaps of the vertices.
+     * Each level is expanded top-down (scanning the arcs of the frontier) or bottom-up (scanning the arcs of the unvisited
+     * vertices for one into the frontier), whichever has fewer arcs to scan. Returns the target reached, or -1.
+     */
+    int search(const std::vector<int> &sources, FlowScratch &scratch) const;
+    /*
+     * Breadth-first search for a shortest augmenting path, on the states of the vertices of a network with limits.
+     * The state of an unlimited vertex is 2v, both its entrance and its exit. Each state keeps the move that reached it:
+     * START, INSIDE for the arc between the entrance and the exit of the vertex, or 3a + kind for arc a, kind being
+     * FRESH (flow on a from an exit to an entrance), UNDO (cancelling flow on the reverse of a, from an entrance to an exit)
+     * or BOTH (between unlimited vertices). Returns the state of the target reached, or -1.
+     */
+    int searchSplit(const std::vector<int> &sources, FlowScratch &scratch) const;
+    static const int START = -2, INSIDE = -3;
+    static const int FRESH = 0, UNDO = 1, BOTH = 2;
+    /*
+     * Room left for a move that reached a state, and the state it came from.
+     */
+    double room(int state, const FlowScratch &scratch, int &previous) const;
+    bool limited(int v) const;
+
+    static const int BOTTOM_UP_FACTOR = 14;     // go bottom-up when frontier arcs * 14 > unexplored arcs
+    static const int TOP_DOWN_FACTOR = 24;      // back to top-down when frontier vertices * 24 < vertices
+
+    /*
+     * Augments flow from the vertices in sources to the vertices in targets until no augmenting path is left.
+     * Sources that are also targets are left out.
+     */
+    double augment(const std::vector<int> &sources, const std::vector<int> &targets, FlowScratch &scratch) const;
+    /*
+     * Same as augment, from the flow already in scratch.
+     */
+    double augmentFrom(const std::vector<int> &sources, const std::vector<int> &targets, FlowScratch &scratch) const;
+    /*
+     * Vertices with a single open edge.
+     */
+    const std::vector<int> &openTerminals(FlowScratch &scratch) const;
+
+    std::vector<int> ids;                   // vertex id of each position
+    std::unordered_map<int, int> indexOf;   // vertex id -> position
+    std::vector<int> offsets;               // first arc of each vertex, offsets[n] == number of arcs
+    std::vector<int> heads;                 // destination of each arc
+    std::vector<int> rev;                   // paired reverse arc
+    std::vector<double> cap;                // capacity, 0 for the reverse arc of a one way edge
+    std::vector<int> price;                 // price of the edge, -1 for the reverse arc of a one way edge
+    std::vector<int> terminals;             // vertices with a single edge
+    std::vector<Edge *> edges;              // edge of the graph each arc was copied from, nullptr for a synthetic reverse arc
+    std::vector<double> limit;              // most flow through each vertex, INF for none, empty when no vertex has a limit
+    std::vector<unsigned int> service;      // service bit of the edge of each arc, empty when the arcs were not copied from edges
+};
+
+#endif /* DA_TP_CLASSES_FLOWNETWORK */
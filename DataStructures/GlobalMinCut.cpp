@@ -0,0 +1,293 @@
+/*
+ * GlobalMinCut.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+#include "GlobalMinCut.h"
+#include "Heap.h"
+#include "UFDS.h"
+
+GlobalMinCut::GlobalMinCut(const FlowNetwork &network) {
+    int n = network.getNumVertex();
+    for (int v = 0; v < n; v++) ids.push_back(network.id(v));
+    for (int a = 0; a < network.getNumArcs(); a++) {
+        int b = network.rev[a], u = network.heads[b], w = network.heads[a];
+        double capacity = std::max(network.cap[a], network.cap[b]);
+        if (a < b && u != w && capacity > 0) links.push_back({u, w, capacity});
+    }
+}
+
+GlobalMinCut::GlobalMinCut(std::vector<int> ids, std::vector<Link> links) : ids(std::move(ids)), links(std::move(links)) {
+}
+
+std::vector<GlobalMinCut> GlobalMinCut::parts() const {
+    int n = (int) ids.size();
+    UFDS sets(n);
+    for (const Link &l : links) sets.linkSets(l.u, l.w);
+
+    // positions of the vertices of each part, in the order of the positions
+    std::vector<int> partOf(n, -1), position(n);
+    std::vector<std::vector<int>> members;
+    for (int v = 0; v < n; v++) {
+        int &p = partOf[sets.findSet(v)];
+        if (p == -1) {
+            p = (int) members.size();
+            members.emplace_back();
+        }
+        position[v] = (int) members[p].size();
+        members[p].push_back(v);
+    }
+    std::vector<std::vector<Link>> partLinks(members.size());
+    for (const Link &l : links) {
+        int p = partOf[sets.findSet(l.u)];
+        partLinks[p].push_back({position[l.u], position[l.w], l.capacity});
+    }
+
+    std::vector<GlobalMinCut> out;
+    for (size_t p = 0; p < members.size(); p++) {
+        if (members[p].size() < 2) continue;
+        std::vector<int> partIds;
+        for (int v : members[p]) partIds.push_back(ids[v]);
+        out.push_back(GlobalMinCut(std::move(partIds), std::move(partLinks[p])));
+    }
+    auto smallest = [](const GlobalMinCut &c) { return *std::min_element(c.ids.begin(), c.ids.end()); };
+    std::sort(out.begin(), out.end(), [&smallest](const GlobalMinCut &a, const GlobalMinCut &b) {
+        return a.ids.size() != b.ids.size() ? a.ids.size() > b.ids.size() : smallest(a) < smallest(b);
+    });
+    return out;
+}
+
+int GlobalMinCut::getNumVertex() const {
+    return (int) ids.size();
+}
+
+GlobalMinCut::Cut GlobalMinCut::stoerWagner() const {
+    int n = (int) ids.size();
+    if (n < 2) return {};
+    std::vector<std::unordered_map<int, double>> adj(n);
+    for (const Link &l : links) {
+        adj[l.u][l.w] += l.capacity;
+        adj[l.w][l.u] += l.capacity;
+    }
+    std::vector<std::vector<int>> members(n);
+    for (int v = 0; v < n; v++) members[v] = {v};
+    std::vector<int> alive(n);
+    for (int v = 0; v < n; v++) alive[v] = v;
+
+    double best = INF;
+    std::vector<int> bestSide;
+    std::vector<double> key(n);
+    std::vector<char> added(n);
+    using Entry = std::pair<double, int>;
+    while (alive.size() > 1) {
+        // maximum adjacency ordering: next is always the vertex most tightly joined to the ones before it,
+        // stale heap entries are skipped rather than updated
+        Heap<Entry, std::greater<Entry>> heap;
+        for (int v : alive) {
+            key[v] = 0;
+            added[v] = 0;
+            heap.insert({0, v});
+        }
+        int previous = -1, last = -1;
+        double cutOfPhase = 0;
+        while (!heap.empty()) {
+            Entry top = heap.extractMin();
+            int v = top.second;
+            if (added[v] || top.first != key[v]) continue;
+            added[v] = 1;
+            previous = last;
+            last = v;
+            cutOfPhase = key[v];
+            for (const auto &e : adj[v]) {
+                if (added[e.first]) continue;
+                key[e.first] += e.second;
+                heap.insert({key[e.first], e.first});
+            }
+        }
+        // the last vertex alone is the cheapest cut between it and the one before it
+        if (cutOfPhase < best) {
+            best = cutOfPhase;
+            bestSide = members[last];
+        }
+
+        for (const auto &e : adj[last]) {
+            if (e.first == previous) continue;
+            adj[previous][e.first] += e.second;
+            adj[e.first][previous] += e.second;
+            adj[e.first].erase(last);
+        }
+        adj[previous].erase(last);
+        adj[last].clear();
+        members[previous].insert(members[previous].end(), members[last].begin(), members[last].end());
+        alive.erase(std::find(alive.begin(), alive.end(), last));
+    }
+
+    std::vector<char> side(n, 0);
+    for (int v : bestSide) side[v] = 1;
+    return describe(best, side);
+}
+
+GlobalMinCut::Contracted GlobalMinCut::contract(const Contracted &network, int size, std::mt19937_64 &random) const {
+    // contracting in the order of exponential keys of rate capacity picks each next link with odds proportional to it
+    std::uniform_real_distribution<double> uniform(0, 1);
+    std::vector<std::pair<double, int>> order;
+    for (size_t i = 0; i < network.links.size(); i++)
+        order.emplace_back(-std::log(1 - uniform(random)) / network.links[i].capacity, (int) i);
+    std::sort(order.begin(), order.end());
+
+    UFDS sets(network.size);
+    for (size_t i = 0; i < order.size() && (int) sets.getNumSets() > size; i++) {
+        const Link &l = network.links[order[i].second];
+        sets.linkSets(l.u, l.w);
+    }
+
+    Contracted out;
+    out.size = 0;
+    std::vector<int> label(network.size, -1);
+    for (int v = 0; v < network.size; v++) {
+        int root = (int) sets.findSet(v);
+        if (label[root] == -1) label[root] = out.size++;
+    }
+    for (int g = 0; g < network.size; g++) out.group.push_back(label[sets.findSet(g)]);
+    for (const Link &l : network.links) {
+        int u = label[sets.findSet(l.u)], w = label[sets.findSet(l.w)];
+        if (u != w) out.links.push_back({std::min(u, w), std::max(u, w), l.capacity});
+    }
+    // links between the same two groups become one, so a network of k groups keeps at most k^2/2 of them
+    std::sort(out.links.begin(), out.links.end(), [](const Link &a, const Link &b) {
+        return a.u != b.u ? a.u < b.u : a.w < b.w;
+    });
+    size_t kept = 0;
+    for (size_t i = 0; i < out.links.size(); i++) {
+        if (kept > 0 && out.links[kept - 1].u == out.links[i].u && out.links[kept - 1].w == out.links[i].w)
+            out.links[kept - 1].capacity += out.links[i].capacity;
+        else out.links[kept++] = out.links[i];
+    }
+    out.links.resize(kept);
+    return out;
+}
+
+double GlobalMinCut::exact(const Contracted &network, std::vector<char> &side) const {
+    int k = network.size;
+    std::vector<std::vector<double>> weight(k, std::vector<double>(k, 0));
+    for (const Link &l : network.links) {
+        weight[l.u][l.w] += l.capacity;
+        weight[l.w][l.u] += l.capacity;
+    }
+    std::vector<std::vector<int>> members(k);
+    for (int g = 0; g < k; g++) members[g].push_back(g);
+    std::vector<char> merged(k, 0), added(k, 0);
+    std::vector<double> attached(k);
+
+    double best = INF;
+    side.assign(k, 0);
+    for (int left = k; left > 1; left--) {
+        std::fill(added.begin(), added.end(), 0);
+        std::fill(attached.begin(), attached.end(), 0);
+        int previous = -1, last = -1;
+        for (int i = 0; i < left; i++) {
+            int next = -1;
+            for (int g = 0; g < k; g++)
+                if (!merged[g] && !added[g] && (next == -1 || attached[g] > attached[next])) next = g;
+            added[next] = 1;
+            previous = last;
+            last = next;
+            for (int g = 0; g < k; g++) attached[g] += weight[next][g];
+        }
+        // the last group ordered against all the others is the cut of this ordering
+        if (attached[last] < best) {
+            best = attached[last];
+            std::fill(side.begin(), side.end(), 0);
+            for (int g : members[last]) side[g] = 1;
+        }
+        merged[last] = 1;
+        members[previous].insert(members[previous].end(), members[last].begin(), members[last].end());
+        for (int g = 0; g < k; g++) {
+            weight[previous][g] += weight[last][g];
+            weight[g][previous] = weight[previous][g];
+        }
+        weight[previous][previous] = 0;
+    }
+    return best;
+}
+
+double GlobalMinCut::recurse(const Contracted &network, std::mt19937_64 &random, std::vector<char> &side) const {
+    int k = network.size;
+    side.assign(k, 0);
+    if (k <= BASE_SIZE) return exact(network, side);
+
+    // two independent tries from a network shrunk to 1 + k/sqrt(2) groups, which keeps a given minimum cut with probability 1/2
+    int size = (int) std::ceil(1 + k / std::sqrt(2.0));
+    double best = INF;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        Contracted smaller = contract(network, size, random);
+        std::vector<char> found;
+        double value = recurse(smaller, random, found);
+        if (value >= best) continue;
+        best = value;
+        // groups of this network that were merged into a group on the side
+        for (int g = 0; g < k; g++) side[g] = found[smaller.group[g]];
+    }
+    return best;
+}
+
+GlobalMinCut::Cut GlobalMinCut::kargerStein(uint64_t seed, int runs) const {
+    int n = (int) ids.size();
+    if (n < 2) return {};
+
+    // a disconnected network needs no search, any of its parts is a cut of 0
+    UFDS sets(n);
+    for (const Link &l : links) sets.linkSets(l.u, l.w);
+    if (sets.getNumSets() > 1) {
+        std::vector<char> side(n, 0);
+        for (int v = 0; v < n; v++) side[v] = sets.isSameSet(v, 0);
+        return describe(0, side);
+    }
+
+    Contracted whole;
+    whole.size = n;
+    for (int v = 0; v < n; v++) whole.group.push_back(v);
+    whole.links = links;
+    std::mt19937_64 random(seed);
+    double best = INF;
+    std::vector<char> bestSide;
+    for (int run = 0; run < std::max(runs, 1); run++) {
+        std::vector<char> side;
+        double value = recurse(whole, random, side);
+        if (value >= best) continue;
+        best = value;
+        bestSide = side;
+    }
+    return describe(best, bestSide);
+}
+
+int GlobalMinCut::highProbabilityRuns(int numVertices) {
+    int depth = (int) std::ceil(std::log2(std::max(numVertices, 2)));
+    return depth * depth;
+}
+
+GlobalMinCut::Cut GlobalMinCut::describe(double value, const std::vector<char> &side) const {
+    int n = (int) ids.size();
+    int count = (int) std::count(side.begin(), side.end(), 1);
+    // report the smaller side, or the one without the first vertex when both are as large
+    char smaller = count * 2 < n || (count * 2 == n && !side[0]) ? 1 : 0;
+
+    Cut cut;
+    cut.value = value;
+    for (int v = 0; v < n; v++)
+        if (side[v] == smaller) cut.side.push_back(ids[v]);
+    std::sort(cut.side.begin(), cut.side.end());
+    for (const Link &l : links) {
+        if (side[l.u] == side[l.w]) continue;
+        bool first = side[l.u] == smaller;
+        cut.segments.emplace_back(ids[first ? l.u : l.w], ids[first ? l.w : l.u]);
+    }
+    std::sort(cut.segments.begin(), cut.segments.end());
+    cut.segments.erase(std::unique(cut.segments.begin(), cut.segments.end()), cut.segments.end());
+    cut.part = ids;
+    std::sort(cut.part.begin(), cut.part.end());
+    return cut;
+}
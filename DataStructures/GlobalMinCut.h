@@ -0,0 +1,96 @@
+/*
+ * GlobalMinCut.h
+ * Cheapest way to split a FlowNetwork in two: the set of edges of least total capacity whose removal disconnects it.
+ *
+ * Edges are taken in both directions, each as wide as its wider direction, like a segment that can be closed as a whole.
+ * Stoer-Wagner finds the exact cut with |V| - 1 maximum adjacency orderings, each merging the last two vertices it ordered,
+ * instead of a maximum flow for every pair of vertices. Karger-Stein contracts random edges, the wider the likelier,
+ * finding a given minimum cut in one run with probability Ω(1/log(|V|)), so it takes log^2(|V|) runs to find it with
+ * high probability, missing it with probability at most 1/|V|^c for a constant c.
+ *
+ * A network in several connected parts has a cut of 0 between them, so each part can be split off and cut on its own.
+ */
+
+#ifndef DA_TP_CLASSES_GLOBALMINCUT
+#define DA_TP_CLASSES_GLOBALMINCUT
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include "FlowNetwork.h"
+
+class GlobalMinCut {
+public:
+    struct Cut {
+        double value = 0;
+        std::vector<int> side;                          // ids of the vertices on the smaller side
+        std::vector<std::pair<int, int>> segments;      // ids of the ends of each edge in the cut, the first on the side
+        std::vector<int> part;                          // ids of the vertices of the network that was cut, sorted
+    };
+
+    /*
+     * Takes the edges of a network. Complexity O(|V| + |E|).
+     */
+    explicit GlobalMinCut(const FlowNetwork &network);
+
+    /*
+     * Exact cut, with a binary heap for the orderings. A network that is already disconnected has a cut of 0 between
+     * its parts, one with fewer than two vertices has no cut. Complexity O(|V|*|E|*log(|E|)).
+     */
+    Cut stoerWagner() const;
+
+    /*
+     * Smallest of the cuts found by some runs of Karger-Stein, each a minimum cut with probability Ω(1/log(|V|)).
+     * The same seed gives the same cut. Complexity O(r*|V|^2*log^2(|V|)) for r runs.
+     */
+    Cut kargerStein(uint64_t seed, int runs) const;
+
+    /*
+     * Runs of kargerStein that find a minimum cut with high probability: ceil(log2(|V|))^2.
+     */
+    static int highProbabilityRuns(int numVertices);
+
+    /*
+     * One network for each connected part of this one with at least two vertices, largest first (ties by smallest id).
+     * Complexity O(|V| + |E|).
+     */
+    std::vector<GlobalMinCut> parts() const;
+
+    int getNumVertex() const;
+
+private:
+    struct Link {
+        int u, w;
+        double capacity;
+    };
+
+    /*
+     * A network with some vertices merged: the group each group of the network it was contracted from is in (each vertex
+     * for the whole network), and the links between groups.
+     */
+    struct Contracted {
+        int size;
+        std::vector<int> group;
+        std::vector<Link> links;
+    };
+
+    std::vector<int> ids;
+    std::vector<Link> links;        // by position, one per pair of arcs with some capacity
+
+    GlobalMinCut(std::vector<int> ids, std::vector<Link> links);
+    static const int BASE_SIZE = 16; // Karger-Stein finishes a network this small with an exact cut
+
+    Contracted contract(const Contracted &network, int size, std::mt19937_64 &random) const;
+    /*
+     * Stoer-Wagner on a small network, with the links added up in a matrix. Complexity O(k^3) for k groups.
+     */
+    double exact(const Contracted &network, std::vector<char> &side) const;
+    /*
+     * Smallest cut found in a network, as the groups on one side.
+     */
+    double recurse(const Contracted &network, std::mt19937_64 &random, std::vector<char> &side) const;
+    Cut describe(double value, const std::vector<char> &side) const;
+};
+
+#endif /* DA_TP_CLASSES_GLOBALMINCUT */
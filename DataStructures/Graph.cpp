@@ -1,7 +1,16 @@
 // By: Gonçalo Leão
 
+#include <cmath>
 #include <map>
 #include "Graph.h"
+#include "Contraction.h"
+#include "GlobalMinCut.h"
+#include "GraphStats.h"
+#include "Heap.h"
+
+unsigned long Graph::getVersion() const {
+    return version;
+}
 
 int Graph::getNumVertex() const {
     return vertexSet.size();
@@ -15,20 +24,16 @@ std::vector<Vertex *> Graph::getVertexSet() const {
  * Auxiliary function to find a vertex with a given content.
  */
 Vertex * Graph::findVertex(const int &id) const {
-    for (auto v : vertexSet)
-        if (v->getId() == id)
-            return v;
-    return nullptr;
+    int idx = findVertexIdx(id);
+    return idx == -1 ? nullptr : vertexSet[idx];
 }
 
 /*
  * Finds the index of the vertex with a given content.
  */
 int Graph::findVertexIdx(const int &id) const {
-    for (unsigned i = 0; i < vertexSet.size(); i++)
-        if (vertexSet[i]->getId() == id)
-            return i;
-    return -1;
+    auto it = vertexIndex.find(id);
+    return it == vertexIndex.end() ? -1 : it->second;
 }
 
 /*
@@ -38,33 +43,81 @@ int Graph::findVertexIdx(const int &id) const {
 bool Graph::addVertex(const int &id) {
     if (findVertex(id) != nullptr)
         return false;
+    vertexIndex.insert({id, (int) vertexSet.size()});
     vertexSet.push_back(new Vertex(id));
+    version++;
+    return true;
+}
+
+bool Graph::setVertexCapacity(const int &id, double capacity) {
+    Vertex *v = findVertex(id);
+    if (v == nullptr)
+        return false;
+    v->setCapacity(capacity);
+    version++;
+    return true;
+}
+
+bool Graph::removeVertex(const int &id) {
+    int idx = findVertexIdx(id);
+    if (idx == -1)
+        return false;
+    Vertex *v = vertexSet[idx];
+    // removeEdge drops every parallel edge at once, so each origin is visited only once
+    std::vector<Vertex *> origins;
+    for (auto e : v->getIncoming())
+        if (std::find(origins.begin(), origins.end(), e->getOrig()) == origins.end())
+            origins.push_back(e->getOrig());
+    for (auto o : origins)
+        o->removeEdge(id);
+    v->removeOutgoingEdges();
+    delete v;
+
+    vertexSet.erase(vertexSet.begin() + idx);
+    vertexIndex.erase(id);
+    for (unsigned i = idx; i < vertexSet.size(); i++)
+        vertexIndex[vertexSet[i]->getId()] = i;
+    version++;
     return true;
 }
 
+void Graph::clear() {
+    for (auto v : vertexSet)
+        v->removeOutgoingEdges();
+    for (auto v : vertexSet)
+        delete v;
+    vertexSet.clear();
+    vertexIndex.clear();
+    version++;
+}
+
 /*
  * Adds an edge to a graph (this), given the contents of the source and
  * destination vertices and the edge weight (w).
  * Returns true if successful, and false if the source or destination vertex does not exist.
  */
-bool Graph::addEdge(const int &sourc, const int &dest, double w, int price) {
+bool Graph::addEdge(const int &sourc, const int &dest, double w, int price, unsigned int service) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
-    v1->addEdge(v2, w, price);
+    v1->addEdge(v2, w, price)->setService(service);
+    version++;
     return true;
 }
 
-bool Graph::addBidirectionalEdge(const int &sourc, const int &dest, double w, int price) {
+bool Graph::addBidirectionalEdge(const int &sourc, const int &dest, double w, int price, unsigned int service) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
     auto e1 = v1->addEdge(v2, w, price);
     auto e2 = v2->addEdge(v1, w, price);
+    e1->setService(service);
+    e2->setService(service);
     e1->setReverse(e2);
     e2->setReverse(e1);
+    version++;
     return true;
 }
 
@@ -91,85 +144,72 @@ Graph::~Graph() {
     deleteMatrix(pathMatrix, vertexSet.size());
 }
 
-void Graph::testAndVisit(std::queue< Vertex*> &q, Edge *e, Vertex *w, double residual) {
-    if (! w->isVisited() && residual > 0) {
-        w->setVisited(true);
-        w->setPath(e);
-        q.push(w);
-    }
-}
+void Graph::edmondsKarp(int source, int target, unsigned int services) {
+    Vertex* s = findVertex(source);
+    Vertex* t = findVertex(target);
+    if (s == nullptr || t == nullptr || s == t)
+        throw std::logic_error("Invalid source and/or target vertex");
 
-bool Graph::findAugmentingPath(Vertex *s, Vertex *t) {
-    for(auto v : vertexSet) {
-        v->setVisited(false);
-    }
-    s->setVisited(true);
-    std::queue<Vertex *> q;
-    q.push(s);
-    while( ! q.empty() && ! t->isVisited()) {
-        auto v = q.front();
-        q.pop();
-        for(auto e: v->getAdj()) {
-            testAndVisit(q, e, e->getDest(), e->getWeight() - e->getFlow());
-        }
-        for(auto e: v->getIncoming()) {
-            testAndVisit(q, e, e->getOrig(), e->getFlow());
-        }
-    }
-    return t->isVisited();
+    const Contraction &contraction = flatOf(services);
+    auto core = contraction.core({source, target});
+    core.network.maxFlow(source, target, *coreScratch);
+    contraction.expand(core, *coreScratch, *flatScratch);
+    // the copy of a mask has no arcs for the other edges
+    if (services != ALL_SERVICES)
+        for (auto v : vertexSet)
+            for (auto e : v->getAdj()) e->setFlow(0);
+    contraction.getNetwork().storeFlows(*flatScratch);
 }
 
-double Graph::findMinResidualAlongPath(Vertex *s, Vertex *t) {
-    double f = INF;
-    for (auto v = t; v != s; ) {
-        auto e = v->getPath();
-        if (e->getDest() == v) {
-            f = std::min(f, e->getWeight() - e->getFlow());
-            v = e->getOrig();
-        }
-        else {
-            f = std::min(f, e->getFlow());
-            v = e->getDest();
-        }
-    }
-    return f;
+void Graph::refreshFlat() {
+    if (flat != nullptr && flatVersion == version) return;
+    flat = std::make_shared<Contraction>(std::make_shared<const FlowNetwork>(*this));
+    serviceFlats.clear();
+    flatScratch = std::make_shared<FlowScratch>();
+    coreScratch = std::make_shared<FlowScratch>();
+    flatVersion = version;
 }
 
-void Graph::augmentFlowAlongPath(Vertex *s, Vertex *t, double f) {
-    for (auto v = t; v != s; ) {
-        auto e = v->getPath();
-        double flow = e->getFlow();
-        if (e->getDest() == v) {
-            e->setFlow(flow + f);
-            v = e->getOrig();
-        }
-        else {
-            e->setFlow(flow - f);
-            v = e->getDest();
-        }
-    }
+const Contraction &Graph::flatOf(unsigned int services) {
+    refreshFlat();
+    if (services == ALL_SERVICES) return *flat;
+    auto &copy = serviceFlats[services];
+    if (copy == nullptr)
+        copy = std::make_shared<Contraction>(std::make_shared<const FlowNetwork>(flat->getNetwork(), services));
+    return *copy;
 }
 
-void Graph::edmondsKarp(int source, int target) {
-    Vertex* s = findVertex(source);
-    Vertex* t = findVertex(target);
-    if (s == nullptr || t == nullptr || s == t)
-        throw std::logic_error("Invalid source and/or target vertex");
+std::vector<std::pair<std::vector<int>, double>> Graph::flowPaths(int source, int target) {
+    refreshFlat();
+    const FlowNetwork &network = flat->getNetwork();
+    network.loadFlows(*flatScratch);
+    std::vector<std::vector<int>> paths;
+    std::vector<double> amounts;
+    network.decompose(source, target, *flatScratch, paths, amounts);
+
+    std::vector<std::pair<std::vector<int>, double>> routes;
+    for (size_t i = 0; i < paths.size(); i++) routes.emplace_back(std::move(paths[i]), amounts[i]);
+    return routes;
+}
 
-    // Reset the flows
-    for (auto v : vertexSet) {
-        for (auto e: v->getAdj()) {
-            e->setFlow(0);
-        }
-    }
-    // Loop to find augmentation paths
-    while( findAugmentingPath(s, t) ) {
-        double f = findMinResidualAlongPath(s, t);
-        augmentFlowAlongPath(s, t, f);
+std::vector<double> Graph::globalMinCut(std::vector<std::vector<int>> &parts, std::vector<std::vector<std::pair<int, int>>> &segments,
+                                        bool randomized, unsigned long seed) {
+    refreshFlat();
+    parts.clear();
+    segments.clear();
+    std::vector<double> values;
+    for (const auto &part : GlobalMinCut(flat->getNetwork()).parts()) {
+        auto cut = randomized ? part.kargerStein(seed, GlobalMinCut::highProbabilityRuns(part.getNumVertex())) : part.stoerWagner();
+        parts.push_back(cut.part);
+        segments.push_back(cut.segments);
+        values.push_back(cut.value);
     }
+    return values;
 }
 
-void Graph::dijkstra(int source) {
+void Graph::dijkstra(int source, unsigned int services) {
+    STATS_PHASE(Phase::Dijkstra);
+    unsigned long long pushes = 0, pops = 0, scanned = 0;
     MutablePriorityQueue<Vertex> q;
 
     for(auto v : vertexSet) {
@@ -182,22 +222,30 @@ void Graph::dijkstra(int source) {
     findVertex(source)->setDist(0);
     findVertex(source)->setCost(0);
     q.insert(findVertex(source));
+    pushes++;
 
 
     while(!q.empty()) {
         auto u = q.extractMin();
+        pops++;
         u->setVisited(true);
 
         for(auto &e : u->getAdj()) {
+            scanned++;
+            if ((e->getService() & services) == 0) continue;
             Vertex* v = e->getDest();
             if (!v->isVisited() && u->getCost() != INF && v->getCost() > u->getCost() + e->getWeight() * e->getPrice()) {
                 v->setDist(u->getDist() + e->getWeight());
                 v->setCost(u->getCost() + e->getWeight() * e->getPrice());
                 v->setPath(e);
                 q.insert(v);
+                pushes++;
             }
         }
     }
+    STATS_ADD(heapPushes, pushes);
+    STATS_ADD(heapPops, pops);
+    STATS_ADD(edgesScanned, scanned);
 }
 
 bool Graph::removeEdge(const int &source, const int &dest) {
@@ -205,10 +253,13 @@ bool Graph::removeEdge(const int &source, const int &dest) {
     if (srcVertex == nullptr) {
         return false;
     }
-    return srcVertex->removeEdge(dest);
+    if (!srcVertex->removeEdge(dest))
+        return false;
+    version++;
+    return true;
 }
 
-list<pair<int, int>> Graph::mostTrains() {
+list<pair<int, int>> Graph::mostTrains(unsigned int services) {
 
     double maxflow = -10;
     list<pair<int, int>> maxflowstations;
@@ -217,32 +268,47 @@ list<pair<int, int>> Graph::mostTrains() {
     for (auto v : vertexSet) {
         double weightSum = 0;
         for (Edge* edge : v->getAdj()) {
-            weightSum += 2*(edge->getWeight());
+            if ((edge->getService() & services) != 0) weightSum += 2*(edge->getWeight());
         }
         weightSumMap[v->getId()] = weightSum;
     }
 
-    // sort the map in descending order of their weightSum
-    vector<pair<int, double>> sortedStations(weightSumMap.begin(), weightSumMap.end());
-    sort(sortedStations.begin(), sortedStations.end(),[](const pair<int, double>& a,const pair<int, double>& b) {return a.second > b.second;});
-
-    for (auto it1 = sortedStations.begin(); it1 != sortedStations.end(); ++it1) {
-        int station1_id = it1->first;
-        if (it1->second < maxflow) {
+    // order the stations by descending weightSum (ties by id), taking them out of the heap only as far as the
+    // pruning below gets, instead of sorting all of them
+    auto heavier = [](const pair<int, double>& a, const pair<int, double>& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    Heap<pair<int, double>, decltype(heavier)> heap(vector<pair<int, double>>(weightSumMap.begin(), weightSumMap.end()), heavier);
+    vector<pair<int, double>> sortedStations;
+    auto sorted = [&](size_t i) {
+        STATS_PHASE(Phase::Sort);
+        while (sortedStations.size() <= i && !heap.empty()) sortedStations.push_back(heap.extractMin());
+        return i < sortedStations.size();
+    };
+
+    // pairs skipped because neither station can beat the best flow so far
+    unsigned long long n = weightSumMap.size(), pruned = 0, solved = 0;
+    for (size_t i = 0; sorted(i); ++i) {
+        int station1_id = sortedStations[i].first;
+        if (sortedStations[i].second < maxflow) {
+            unsigned long long left = n - i;
+            pruned += left * (left - 1) / 2;
             break;
         }
 
         double flow = 0;
-        for (auto it2 = it1; it2 != sortedStations.end(); ++it2) {
-            int station2_id = it2->first;
-            if (it2->second < maxflow) {
+        for (size_t j = i; sorted(j); ++j) {
+            int station2_id = sortedStations[j].first;
+            if (sortedStations[j].second < maxflow) {
+                pruned += n - j;
                 break;
             }
             if (station1_id == station2_id) {
                 continue;
             }
             else {
-                edmondsKarp(station1_id, station2_id);
+                edmondsKarp(station1_id, station2_id, services);
+                solved++;
 
                 for (const auto e : findVertex(station1_id)->getAdj()) {
                     flow += e->getFlow();
@@ -262,5 +328,7 @@ list<pair<int, int>> Graph::mostTrains() {
         }
     }
 
+    STATS_ADD(pairsSolved, solved);
+    STATS_ADD(pairsPruned, pruned);
     return maxflowstations;
 }
\ No newline at end of file
@@ -9,11 +9,16 @@
 #include <limits>
 #include <algorithm>
 #include <list>
+#include <memory>
+#include <unordered_map>
 #include "MutablePriorityQueue.h"
 #include "VertexEdge.h"
 
 using namespace std;
 
+class Contraction;
+class FlowScratch;
+
 class Graph {
 public:
     ~Graph();
@@ -29,41 +34,91 @@ public:
 
     /*
      * Adds an edge to a graph (this), given the contents of the source and
-     * destination vertices and the edge weight (w).
+     * destination vertices, the edge weight (w) and the bit of the service that runs on it.
      * Returns true if successful, and false if the source or destination vertex does not exist.
      */
-    bool addEdge(const int &sourc, const int &dest, double w, int price);
-    bool addBidirectionalEdge(const int &sourc, const int &dest, double w, int price);
+    bool addEdge(const int &sourc, const int &dest, double w, int price, unsigned int service = ALL_SERVICES);
+    bool addBidirectionalEdge(const int &sourc, const int &dest, double w, int price, unsigned int service = ALL_SERVICES);
+
+    /*
+     * Removes a vertex with a given id from a graph (this), along with every edge to or from it.
+     * Returns true if successful, and false if such vertex does not exist.
+     */
+    bool removeVertex(const int &id);
+    /*
+     * Limits the flow that can pass through a vertex, INF for no limit, in every max flow of the graph.
+     * Returns true if successful, and false if such vertex does not exist.
+     */
+    bool setVertexCapacity(const int &id, double capacity);
+    /*
+     * Removes every vertex and edge from a graph (this).
+     */
+    void clear();
 
     int getNumVertex() const;
+    /*
+     * Counter bumped by every change to the vertices or edges, so results computed on an older graph can be told apart.
+     */
+    unsigned long getVersion() const;
     bool removeEdge(const int &source, const int &dest);
     std::vector<Vertex *> getVertexSet() const;
 
-    void testAndVisit(std::queue< Vertex*> &q, Edge *e, Vertex *w, double residual);
-    bool findAugmentingPath(Vertex *s, Vertex *t);
-    double findMinResidualAlongPath(Vertex *s, Vertex *t);
-    void augmentFlowAlongPath(Vertex *s, Vertex *t, double f);
-
-    /** Implementation of the Edmonds-Karp algorithm
+    /** Implementation of the Edmonds-Karp algorithm, on a flat copy of the graph (rebuilt when the graph changes)
+     * whose searches go top-down or bottom-up by frontier size. It runs on the core where the chains of stations
+     * with two neighbours are contracted, then the flow of every edge is set to the result
      * @brief Complexity O(|V|*|E|^2)
      * @param source id of the source vertex
      * @param target id of the target vertex
+     * @param services mask of the services whose edges the flow can use, each mask runs on its own copy of the graph
+     * with only those edges, and the other edges are left with no flow
      */
-    void edmondsKarp(int source, int target);
+    void edmondsKarp(int source, int target, unsigned int services = ALL_SERVICES);
+
+    /** Global minimum cut of each connected part of the graph with at least two vertices: the segments of least total
+     * capacity whose closure splits the part in two, on the same flat copy as edmondsKarp, without a max flow per pair of
+     * stations. Stoer-Wagner, or Karger-Stein when randomized, repeated log^2 times the size of the part so it is right
+     * with high probability. Between the parts of a disconnected graph the cut is 0, so each part is cut on its own
+     * @brief Complexity O(|V|*|E|*log(|E|)), or O(|V|^2*log^4(|V|)) when randomized
+     * @param parts ids of the vertices of each part, sorted, largest part first (ties by smallest id)
+     * @param segments for each part, ids of the stations at the ends of each segment in its cut, the first on the smaller side
+     * @param randomized whether to run Karger-Stein
+     * @param seed seed of the random contractions, the same seed gives the same cuts
+     * @return total capacity of the cut of each part
+     */
+    std::vector<double> globalMinCut(std::vector<std::vector<int>> &parts, std::vector<std::vector<std::pair<int, int>>> &segments,
+                                     bool randomized = false, unsigned long seed = 0);
+
+    /** Function that splits the flow in the edges, as left by edmondsKarp, into the routes of the trains from source
+     * to target, with the trains on each, after cancelling the cycles the flow has
+     * @brief Complexity O(|E| + (p+c)*|V|) for p routes and c cycles
+     * @param source id of the source vertex
+     * @param target id of the target vertex
+     * @return ids of the vertices along each route, with its number of trains
+     */
+    std::vector<std::pair<std::vector<int>, double>> flowPaths(int source, int target);
 
     /** Function that goes through the graph and returns the pairs of stations with the most trains
+     * @param services mask of the services whose edges the trains can use
      * @return list of pairs of stations with the most trains
      * @brief Complexity O(|V|^2+|E|^2)
      */
-    list<pair<int, int>> mostTrains();
+    list<pair<int, int>> mostTrains(unsigned int services = ALL_SERVICES);
 
     /** Implementation of the Dijkstra algorithm
+     * @param services mask of the services whose edges the paths can use
      * @brief Complexity O(n^2) where n is the number of connections
      */
-    void dijkstra(int source);
+    void dijkstra(int source, unsigned int services = ALL_SERVICES);
 
 protected:
     std::vector<Vertex *> vertexSet;    // vertex set
+    std::unordered_map<int, int> vertexIndex;    // vertex id -> position in vertexSet
+    unsigned long version = 0;    // see getVersion
+
+    std::shared_ptr<Contraction> flat;    // flat copy used by edmondsKarp, with its chains
+    std::unordered_map<unsigned int, std::shared_ptr<Contraction>> serviceFlats;    // copies of flat with the edges of a mask of services only
+    std::shared_ptr<FlowScratch> flatScratch, coreScratch;
+    unsigned long flatVersion = 0;    // version of the graph flat was built from
 
     double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
     int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
@@ -72,6 +127,14 @@ protected:
      * Finds the index of the vertex with a given content.
      */
     int findVertexIdx(const int &id) const;
+    /*
+     * Rebuilds flat if the graph changed since it was built.
+     */
+    void refreshFlat();
+    /*
+     * Flat copy with only the edges of a mask of services, built from flat the first time the mask is asked for.
+     */
+    const Contraction &flatOf(unsigned int services);
 };
 
 void deleteMatrix(int **m, int n);
@@ -0,0 +1,52 @@
+/*
+ * GraphStats.cpp
+ */
+
+#include "GraphStats.h"
+
+GraphStats &graphStats() {
+    static GraphStats stats;
+    return stats;
+}
+
+void GraphStats::reset() {
+    maxFlowRuns = 0;
+    augmentingPaths = 0;
+    edgesScanned = 0;
+    adjacencyCopies = 0;
+    heapPushes = 0;
+    heapPops = 0;
+    pairsSolved = 0;
+    pairsPruned = 0;
+    cacheHits = 0;
+    cacheMisses = 0;
+    for (auto &p : phaseNanos) p = 0;
+}
+
+void GraphStats::print(std::ostream &os) const {
+    static const char *phaseNames[] = {"reset", "search", "augment", "dijkstra", "sort"};
+    os << "[stats] max-flow runs " << maxFlowRuns
+       << ", augmenting paths " << augmentingPaths
+       << ", edges scanned " << edgesScanned
+       << ", adjacency copies " << adjacencyCopies
+       << ", heap pushes " << heapPushes
+       << ", heap pops " << heapPops
+       << ", pairs solved " << pairsSolved
+       << ", pairs pruned " << pairsPruned
+       << ", cache hits " << cacheHits
+       << ", cache misses " << cacheMisses << '\n';
+    os << "[stats]";
+    for (int p = 0; p < (int) Phase::Count; p++)
+        os << (p == 0 ? " " : ", ") << phaseNames[p] << ' ' << phaseNanos[p] / 1e6 << " ms";
+    os << '\n';
+}
+
+PhaseTimer::PhaseTimer(Phase phase): phase(phase), active(graphStats().enabled) {
+    if (active) start = std::chrono::steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer() {
+    if (!active) return;
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    graphStats().phaseNanos[(int) phase].fetch_add((unsigned long long) elapsed.count(), std::memory_order_relaxed);
+}
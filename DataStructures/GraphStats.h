@@ -0,0 +1,67 @@
+/*
+ * GraphStats.h
+ * Counters and phase timers for the graph algorithms.
+ *
+ * Compiled in when GRAPH_STATS is defined (the default, see the DATP1_STATS CMake option) and
+ * off at run time until enabled, so a disabled build or run only pays for a branch per call.
+ */
+
+#ifndef DA_TP_CLASSES_GRAPHSTATS
+#define DA_TP_CLASSES_GRAPHSTATS
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+enum class Phase { Reset, Search, Augment, Dijkstra, Sort, Count };
+
+class GraphStats {
+public:
+    bool enabled = false;
+
+    std::atomic<unsigned long long> maxFlowRuns{0};
+    std::atomic<unsigned long long> augmentingPaths{0};
+    std::atomic<unsigned long long> edgesScanned{0};
+    std::atomic<unsigned long long> adjacencyCopies{0};
+    std::atomic<unsigned long long> heapPushes{0};
+    std::atomic<unsigned long long> heapPops{0};
+    std::atomic<unsigned long long> pairsSolved{0};
+    std::atomic<unsigned long long> pairsPruned{0};
+    std::atomic<unsigned long long> cacheHits{0};
+    std::atomic<unsigned long long> cacheMisses{0};
+    std::atomic<unsigned long long> phaseNanos[(int) Phase::Count] = {};
+
+    void reset();
+    void print(std::ostream &os) const;
+};
+
+/*
+ * The counters every algorithm reports to. They are atomic, but the algorithms add
+ * per-call totals rather than per-edge increments to keep that cheap.
+ */
+GraphStats &graphStats();
+
+/*
+ * Adds the time between its construction and destruction to a phase.
+ */
+class PhaseTimer {
+public:
+    explicit PhaseTimer(Phase phase);
+    ~PhaseTimer();
+private:
+    Phase phase;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
+
+#ifdef GRAPH_STATS
+#define STATS_ADD(counter, n) do { if (graphStats().enabled) graphStats().counter.fetch_add((n), std::memory_order_relaxed); } while (0)
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+#define STATS_PHASE(phase) PhaseTimer STATS_CONCAT(phaseTimer, __LINE__)(phase)
+#else
+#define STATS_ADD(counter, n) do { } while (0)
+#define STATS_PHASE(phase) do { } while (0)
+#endif
+
+#endif /* DA_TP_CLASSES_GRAPHSTATS */
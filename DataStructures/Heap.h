@@ -4,19 +4,142 @@
 #ifndef DA_TP_CLASSES_HEAP
 #define DA_TP_CLASSES_HEAP
 
+#include <algorithm>
+#include <functional>
 #include <vector>
 
+/*
+ * Binary heap of T whose top is the element that comes first by Compare (the smallest, with the default std::less).
+ */
+template <class T, class Compare = std::less<T>>
 class Heap {
 public:
-    Heap();
-    Heap(std::vector<int> v);
-	void insert(int x);
-	int extractMin();
-	bool empty();
+    explicit Heap(Compare compare = Compare());
+    /*
+     * Builds a heap with every element of v at once, in O(n).
+     */
+    Heap(std::vector<T> v, Compare compare = Compare());
+    void insert(const T &x);
+    /*
+     * Inserts x while keeping at most k elements: when the heap is full, x replaces the top if the top comes before x.
+     * A heap whose Compare puts the worst first thus keeps the best k elements it was offered. Complexity O(log(k)).
+     */
+    void insertBounded(const T &x, size_t k);
+    T extractMin();
+    const T &top() const;
+    bool empty() const;
+    size_t size() const;
 private:
-    std::vector<int> elems;
-    void heapifyUp(unsigned int i);
-    void heapifyDown(unsigned int i);
+    std::vector<T> elems;
+    Compare compare;
+    void heapifyUp(size_t i);
+    void heapifyDown(size_t i);
+
+    // Index calculations
+    static constexpr size_t parentOf(size_t i) { return i / 2; }
+    static constexpr size_t leftChildOf(size_t i) { return i * 2; }
 };
 
+/*
+ * Returns the k best elements of items, best first, where better(a, b) tells if a is better than b.
+ * Complexity O(n*log(k)).
+ */
+template <class T, class Better>
+std::vector<T> topK(const std::vector<T> &items, size_t k, Better better) {
+    auto worseFirst = [&better](const T &a, const T &b) { return better(b, a); };
+    Heap<T, decltype(worseFirst)> kept(worseFirst);
+    for (const auto &x : items) kept.insertBounded(x, k);
+
+    std::vector<T> best(kept.size());
+    for (size_t i = best.size(); i > 0; i--) best[i - 1] = kept.extractMin();
+    return best;
+}
+
+template <class T, class Compare>
+Heap<T, Compare>::Heap(Compare compare): compare(compare) {
+    elems.resize(1);
+	// indices will be used starting in 1
+	// to facilitate parent/child calculations
+}
+
+template <class T, class Compare>
+Heap<T, Compare>::Heap(std::vector<T> v, Compare compare): Heap(compare) {
+    // Add the elements to the vector without respecting the heap property
+    elems.insert(elems.end(), std::make_move_iterator(v.begin()), std::make_move_iterator(v.end()));
+
+    // Move the elements around so that the heap property is respected
+    // There is no need to heapify the elements with higher indices since they are leaf nodes
+    for (size_t i = v.size() / 2; i > 0; i--) {
+        heapifyDown(i);
+    }
+}
+
+template <class T, class Compare>
+bool Heap<T, Compare>::empty() const {
+    return elems.size() == 1;
+}
+
+template <class T, class Compare>
+size_t Heap<T, Compare>::size() const {
+    return elems.size() - 1;
+}
+
+template <class T, class Compare>
+const T &Heap<T, Compare>::top() const {
+    return elems[1];
+}
+
+template <class T, class Compare>
+T Heap<T, Compare>::extractMin() {
+    T x = std::move(elems[1]);
+    if (elems.size() > 2) elems[1] = std::move(elems.back());
+    elems.pop_back();
+    if (elems.size() > 1) heapifyDown(1);
+    return x;
+}
+
+template <class T, class Compare>
+void Heap<T, Compare>::insert(const T &x) {
+    elems.push_back(x);
+    heapifyUp(elems.size() - 1);
+}
+
+template <class T, class Compare>
+void Heap<T, Compare>::insertBounded(const T &x, size_t k) {
+    if (size() < k) {
+        insert(x);
+    }
+    else if (k > 0 && compare(elems[1], x)) {
+        elems[1] = x;
+        heapifyDown(1);
+    }
+}
+
+template <class T, class Compare>
+void Heap<T, Compare>::heapifyUp(size_t i) {
+    T x = std::move(elems[i]);
+    while (i > 1 && compare(x, elems[parentOf(i)])) {
+        elems[i] = std::move(elems[parentOf(i)]);
+        i = parentOf(i);
+    }
+    elems[i] = std::move(x);
+}
+
+template <class T, class Compare>
+void Heap<T, Compare>::heapifyDown(size_t i) {
+    T x = std::move(elems[i]);
+    while (true) {
+        size_t k = leftChildOf(i);
+        if (k >= elems.size())
+            break;
+        if (k + 1 < elems.size() && compare(elems[k + 1], elems[k]))
+            ++k; // right child of i
+        if (!compare(elems[k], x))
+            break;
+        elems[i] = std::move(elems[k]);
+        i = k;
+    }
+    elems[i] = std::move(x);
+}
+
 #endif /* DA_TP_CLASSES_HEAP */
@@ -0,0 +1,125 @@
+/*
+ * LruCache.h
+ * A bounded map that forgets the least recently used entry when it is full.
+ * It does no locking: callers that share one between threads must hold a lock around every call.
+ */
+
+#ifndef DA_TP_CLASSES_LRUCACHE
+#define DA_TP_CLASSES_LRUCACHE
+
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+template <class K, class V, class H = std::hash<K>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity);
+
+    /*
+     * Copies the value of a key into value and marks it as the most recently used. Returns false if the key is not cached.
+     * Complexity O(1).
+     */
+    bool get(const K &key, V &value);
+    /*
+     * Stores the value of a key, evicting the least recently used entry if the cache is full. Complexity O(1).
+     */
+    void put(const K &key, const V &value);
+    /*
+     * Drops every entry and limits the cache to a new number of entries, 0 caches nothing.
+     */
+    void resize(size_t capacity);
+    /*
+     * Drops every entry whose key and value the predicate holds for. Complexity O(n) calls of the predicate.
+     */
+    template <class P>
+    void eraseIf(P predicate);
+
+    size_t size() const;
+    size_t getCapacity() const;
+    unsigned long getHits() const;
+    unsigned long getMisses() const;
+
+private:
+    typedef std::list<std::pair<K, V>> Entries;
+    Entries entries;    // most recently used first
+    std::unordered_map<K, typename Entries::iterator, H> index;
+    size_t capacity;
+    unsigned long hits = 0, misses = 0;
+};
+
+template <class K, class V, class H>
+LruCache<K, V, H>::LruCache(size_t capacity): capacity(capacity) {}
+
+template <class K, class V, class H>
+bool LruCache<K, V, H>::get(const K &key, V &value) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    value = it->second->second;
+    return true;
+}
+
+template <class K, class V, class H>
+void LruCache<K, V, H>::put(const K &key, const V &value) {
+    if (capacity == 0) return;
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = value;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    if (entries.size() == capacity) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(key, value);
+    index[key] = entries.begin();
+}
+
+template <class K, class V, class H>
+void LruCache<K, V, H>::resize(size_t capacity) {
+    entries.clear();
+    index.clear();
+    this->capacity = capacity;
+}
+
+template <class K, class V, class H>
+template <class P>
+void LruCache<K, V, H>::eraseIf(P predicate) {
+    for (auto it = entries.begin(); it != entries.end(); ) {
+        if (!predicate(it->first, it->second)) {
+            ++it;
+            continue;
+        }
+        index.erase(it->first);
+        it = entries.erase(it);
+    }
+}
+
+template <class K, class V, class H>
+size_t LruCache<K, V, H>::size() const {
+    return entries.size();
+}
+
+template <class K, class V, class H>
+size_t LruCache<K, V, H>::getCapacity() const {
+    return capacity;
+}
+
+template <class K, class V, class H>
+unsigned long LruCache<K, V, H>::getHits() const {
+    return hits;
+}
+
+template <class K, class V, class H>
+unsigned long LruCache<K, V, H>::getMisses() const {
+    return misses;
+}
+
+#endif /* DA_TP_CLASSES_LRUCACHE */
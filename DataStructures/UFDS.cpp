@@ -6,33 +6,49 @@
  *      Author: Gonçalo Leão
  */
 
+#include <utility>
 #include "UFDS.h"
 
 UFDS::UFDS(unsigned int N) {
     path.resize(N);
-    rank.resize(N);
-    for (unsigned long i = 0; i < N; i++) {
+    size.resize(N);
+    reset();
+}
+
+void UFDS::reset() {
+    for (unsigned long i = 0; i < path.size(); i++) {
         path[i] = i;
-        rank[i] = 0;
+        size[i] = 1;
     }
+    numSets = path.size();
 }
 
 unsigned long UFDS::findSet(unsigned int i) {
-    if (path[i] != i) path[i] = findSet(path[i]);
-    return path[i];
+    while (path[i] != i) {
+        path[i] = path[path[i]];
+        i = path[i];
+    }
+    return i;
 }
 
 bool UFDS::isSameSet(unsigned int i, unsigned int j) {
     return findSet(i) == findSet(j);
 }
 
-void UFDS::linkSets(unsigned int i, unsigned int j) {
-    if (!isSameSet(i, j)) {
-        unsigned long x = findSet(i), y = findSet(j);
-        if (rank[x] > rank[y]) path[y] = x; // x becomes the root due to having a larger rank
-        else {
-            path[x] = y; // y becomes the root due to having a larger rank, or ...
-            if (rank[x] == rank[y]) rank[y]++; // ... due to both nodes having the same rank (in order to break the tie)
-        }
-    }
-}
\ No newline at end of file
+bool UFDS::linkSets(unsigned int i, unsigned int j) {
+    unsigned long x = findSet(i), y = findSet(j);
+    if (x == y) return false;
+    if (size[x] < size[y]) std::swap(x, y); // x becomes the root due to having the larger set
+    path[y] = x;
+    size[x] += size[y];
+    numSets--;
+    return true;
+}
+
+unsigned int UFDS::setSize(unsigned int i) {
+    return size[findSet(i)];
+}
+
+unsigned int UFDS::getNumSets() const {
+    return numSets;
+}
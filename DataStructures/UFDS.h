@@ -14,12 +14,30 @@
 class UFDS {
 public:
     UFDS(unsigned int N);
+    /*
+     * Root of the set of node i. Every node on the way is pointed at its grandparent (path halving),
+     * without recursion, so long chains cannot overflow the stack.
+     */
     unsigned long findSet(unsigned int i);
     bool isSameSet(unsigned int i, unsigned int j);
-    void linkSets(unsigned int i, unsigned int j);
+    /*
+     * Joins the sets of nodes i and j, the smaller one under the root of the larger one (union by size).
+     * Returns false if they were already the same set.
+     */
+    bool linkSets(unsigned int i, unsigned int j);
+    /*
+     * Number of nodes in the set of node i.
+     */
+    unsigned int setSize(unsigned int i);
+    unsigned int getNumSets() const;
+    /*
+     * Makes every node a set of its own again, in O(n).
+     */
+    void reset();
 private:
     std::vector<unsigned int> path; // Ancestor of node i (which can be itself). It is used to determine if two nodes are part of the same set.
-    std::vector<unsigned int> rank; // Upper bound for the height of a tree whose root is node i.
+    std::vector<unsigned int> size; // Number of nodes in the set whose root is node i.
+    unsigned int numSets;
 };
 
 
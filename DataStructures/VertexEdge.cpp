@@ -1,6 +1,7 @@
 // By: Gonçalo Leão
 
 #include "VertexEdge.h"
+#include "GraphStats.h"
 
 /************************* Vertex  **************************/
 
@@ -61,6 +62,7 @@ int Vertex::getId() const {
 }
 
 std::vector<Edge*> Vertex::getAdj() const {
+    STATS_ADD(adjacencyCopies, 1);
     return this->adj;
 }
 
@@ -85,6 +87,7 @@ Edge *Vertex::getPath() const {
 }
 
 std::vector<Edge *> Vertex::getIncoming() const {
+    STATS_ADD(adjacencyCopies, 1);
     return this->incoming;
 }
 
@@ -120,6 +123,14 @@ void Vertex::setCost(double cost) {
     this->cost = cost;
 }
 
+double Vertex::getCapacity() const {
+    return this->capacity;
+}
+
+void Vertex::setCapacity(double capacity) {
+    this->capacity = capacity;
+}
+
 void Vertex::deleteEdge(Edge *edge) {
     Vertex *dest = edge->getDest();
     // Remove the corresponding edge from the incoming list
@@ -167,6 +178,10 @@ int Edge::getPrice() const {
     return price;
 }
 
+unsigned int Edge::getService() const {
+    return service;
+}
+
 void Edge::setSelected(bool selected) {
     this->selected = selected;
 }
@@ -182,3 +197,7 @@ void Edge::setFlow(double flow) {
 void Edge::setPrice(int price) {
     this->price = price;
 }
+
+void Edge::setService(unsigned int service) {
+    this->service = service;
+}
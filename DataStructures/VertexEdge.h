@@ -13,6 +13,7 @@
 class Edge;
 
 #define INF std::numeric_limits<double>::max()
+#define ALL_SERVICES 0xFFFFFFFFu
 
 /************************* Vertex  **************************/
 
@@ -30,6 +31,7 @@ public:
     Edge *getPath() const;
     std::vector<Edge *> getIncoming() const;
     double getCost() const;
+    double getCapacity() const;
 
     void setId(int info);
     void setVisited(bool visited);
@@ -41,6 +43,7 @@ public:
     bool removeEdge(int destID);
     void removeOutgoingEdges();
     void setCost(double cost);
+    void setCapacity(double capacity);
 
     friend class MutablePriorityQueue<Vertex>;
 protected:
@@ -55,6 +58,7 @@ protected:
     Edge *path = nullptr;
 
     double cost = 0;
+    double capacity = INF; // most flow that can pass through the vertex
 
     std::vector<Edge *> incoming; // incoming edges
 
@@ -76,11 +80,13 @@ public:
     Edge *getReverse() const;
     double getFlow() const;
     int getPrice() const;
+    unsigned int getService() const;
 
     void setSelected(bool selected);
     void setReverse(Edge *reverse);
     void setFlow(double flow);
     void setPrice(int price);
+    void setService(unsigned int service);
 protected:
     Vertex * dest; // destination vertex
     double weight; // edge weight, can also be used for capacity
@@ -95,6 +101,7 @@ protected:
     double flow; // for flow-related problems
 
     int price;
+    unsigned int service = ALL_SERVICES; // bit of the service that runs on the edge, every bit if it has none
 };
 
 #endif /* DA_TP_CLASSES_VERTEX_EDGE */
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*
+ * WidestPaths.cpp
+ */
+
+#include <algorithm>
+#include <queue>
+#include "UFDS.h"
+#include "WidestPaths.h"
+
+WidestPaths::WidestPaths(std::shared_ptr<const FlowNetwork> network): network(std::move(network)) {
+    const FlowNetwork &net = *this->network;
+    int n = net.getNumVertex();
+
+    // Kruskal's algorithm on the pairs of arcs, widest first, each pair as wide as its wider direction
+    std::vector<int> pairs;
+    for (int a = 0; a < net.getNumArcs(); a++)
+        if (a < net.rev[a] && net.heads[a] != net.heads[net.rev[a]]) pairs.push_back(a);
+    auto width = [&](int a) { return std::max(net.cap[a], net.cap[net.rev[a]]); };
+    std::sort(pairs.begin(), pairs.end(), [&](int a, int b) {
+        return width(a) != width(b) ? width(a) > width(b) : a < b;
+    });
+    UFDS sets(n);
+    std::vector<std::vector<std::pair<int, double>>> adj(n);
+    for (int a : pairs) {
+        int u = net.heads[net.rev[a]], w = net.heads[a];
+        if (width(a) <= 0 || !sets.linkSets(u, w)) continue;
+        adj[u].emplace_back(w, width(a));
+        adj[w].emplace_back(u, width(a));
+    }
+
+    levels = 1;
+    while ((1 << levels) < n) levels++;
+    depth.assign(n, -1);
+    component.assign(n, -1);
+    up.assign((size_t) levels * n, 0);
+    narrowest.assign((size_t) levels * n, INF);
+    std::queue<int> q;
+    for (int root = 0; root < n; root++) {
+        if (depth[root] != -1) continue;
+        depth[root] = 0;
+        component[root] = root;
+        up[root] = root;
+        q.push(root);
+        while (!q.empty()) {
+            int v = q.front();
+            q.pop();
+            for (const auto &e : adj[v]) {
+                if (depth[e.first] != -1) continue;
+                depth[e.first] = depth[v] + 1;
+                component[e.first] = root;
+                up[e.first] = v;
+                narrowest[e.first] = e.second;
+                q.push(e.first);
+            }
+        }
+    }
+    for (int k = 1; k < levels; k++) {
+        for (int v = 0; v < n; v++) {
+            int mid = up[(k - 1) * n + v];
+            up[k * n + v] = up[(k - 1) * n + mid];
+            narrowest[k * n + v] = std::min(narrowest[(k - 1) * n + v], narrowest[(k - 1) * n + mid]);
+        }
+    }
+}
+
+int WidestPaths::meet(int u, int w, double &width) const {
+    int n = network->getNumVertex();
+    width = INF;
+    if (depth[u] < depth[w]) std::swap(u, w);
+    for (int k = levels - 1; k >= 0; k--) {
+        if (depth[u] - (1 << k) < depth[w]) continue;
+        width = std::min(width, narrowest[k * n + u]);
+        u = up[k * n + u];
+    }
+    if (u == w) return u;
+    for (int k = levels - 1; k >= 0; k--) {
+        if (up[k * n + u] == up[k * n + w]) continue;
+        width = std::min({width, narrowest[k * n + u], narrowest[k * n + w]});
+        u = up[k * n + u];
+        w = up[k * n + w];
+    }
+    width = std::min({width, narrowest[u], narrowest[w]});
+    return up[u];
+}
+
+double WidestPaths::bottleneck(int source, int target) const {
+    int s = network->index(source), t = network->index(target);
+    if (s == -1 || t == -1 || s == t || component[s] != component[t]) return 0;
+    double width;
+    meet(s, t, width);
+    return width;
+}
+
+std::vector<int> WidestPaths::path(int source, int target) const {
+    std::vector<int> ids;
+    if (bottleneck(source, target) <= 0) return ids;
+    int s = network->index(source), t = network->index(target);
+    double width;
+    int top = meet(s, t, width);
+
+    // climb from the source to the meeting vertex, then from the target, and turn the second climb around
+    for (int v = s; v != top; v = up[v]) ids.push_back(network->id(v));
+    ids.push_back(network->id(top));
+    size_t turn = ids.size();
+    for (int v = t; v != top; v = up[v]) ids.push_back(network->id(v));
+    std::reverse(ids.begin() + (long) turn, ids.end());
+    return ids;
+}
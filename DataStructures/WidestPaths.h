@@ -0,0 +1,52 @@
+/*
+ * WidestPaths.h
+ * Widest single route (the one whose narrowest segment carries the most trains) between any two vertices of a FlowNetwork.
+ *
+ * The widest route between two vertices always runs along a maximum spanning forest: an edge left out by Kruskal's
+ * algorithm closes a cycle of edges at least as wide, so a route through it can go around it without getting narrower.
+ * The forest is rooted and every vertex keeps its ancestors 2^k levels up with the narrowest edge on the way (binary
+ * lifting), so both climbs to the lowest common ancestor take O(log(|V|)) jumps. Edges are taken in both directions.
+ */
+
+#ifndef DA_TP_CLASSES_WIDESTPATHS
+#define DA_TP_CLASSES_WIDESTPATHS
+
+#include <memory>
+#include <vector>
+#include "FlowNetwork.h"
+
+class WidestPaths {
+public:
+    /*
+     * Builds the maximum spanning forest of a network, which must not change while it exists, by the capacity of
+     * its edges. Complexity O(|E|*log(|E|) + |V|*log(|V|)).
+     */
+    explicit WidestPaths(std::shared_ptr<const FlowNetwork> network);
+
+    /*
+     * Capacity of the narrowest segment of the widest route between two vertices (by id), 0 if a vertex does not
+     * exist, the two are the same or they are not connected. Complexity O(log(|V|)).
+     */
+    double bottleneck(int source, int target) const;
+
+    /*
+     * Ids of the vertices along the widest route from source to target, empty when bottleneck is 0.
+     * Complexity O(log(|V|) + l) for l vertices on the route.
+     */
+    std::vector<int> path(int source, int target) const;
+
+private:
+    std::shared_ptr<const FlowNetwork> network;
+    int levels;                     // jumps of 1, 2, 4, ... 2^(levels - 1)
+    std::vector<int> depth;         // of each vertex in its tree
+    std::vector<int> component;     // root of the tree of each vertex
+    std::vector<int> up;            // up[k * n + v]: ancestor 2^k levels above v, itself past the root
+    std::vector<double> narrowest;  // narrowest[k * n + v]: narrowest edge on that climb, INF for none
+
+    /*
+     * Lowest common ancestor of two vertices (by position) of the same tree, and the narrowest edge on the way to it.
+     */
+    int meet(int u, int w, double &width) const;
+};
+
+#endif /* DA_TP_CLASSES_WIDESTPATHS */
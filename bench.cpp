@@ -0,0 +1,171 @@
+/*! \file */
+
+/**
+ * @brief Benchmark suite of the loaders and algorithms, on the shipped datasets and on generated ones
+ *
+ * Usage: bench [--files DIRECTORY] [--work DIRECTORY] [--repeat N] [--sizes N,N,...] [--most-trains-limit N]
+ * Every benchmark runs once to warm up and then N times; one csv line is printed per benchmark and dataset:
+ * benchmark,dataset,stations,connections,runs,median_ms,min_ms,max_ms,items,items_per_s
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "headers/Dataset.h"
+#include "headers/NetworkGenerator.h"
+#include "headers/Queries.h"
+#include "headers/Snapshot.h"
+
+using namespace std;
+
+/** Dataset measured by the suite */
+struct BenchDataset {
+    string name;
+    string stations_file;
+    string network_file;
+};
+
+/** Options of the suite */
+struct BenchOptions {
+    string files = "../files";
+    string work = (filesystem::temp_directory_path() / "datp1-bench").string();
+    int repeat = 5;
+    vector<int> sizes = {1000, 10000, 100000};
+    int mostTrainsLimit = 600;
+};
+
+/** Function that times a benchmark: one warm-up run and then options.repeat measured runs, setup is not timed
+ * @brief Complexity O(r) runs of the benchmark
+ */
+void measure(const BenchOptions& options, const string& benchmark, const string& dataset, long items,
+             const function<void()>& setup, const function<void()>& run) {
+    vector<double> times;
+    for (int i = 0; i <= options.repeat; i++) {
+        setup();
+        auto start = chrono::steady_clock::now();
+        run();
+        auto end = chrono::steady_clock::now();
+        if (i > 0) times.push_back(chrono::duration<double, milli>(end - start).count());
+    }
+    sort(times.begin(), times.end());
+    double median = times[times.size() / 2];
+
+    cout << benchmark << ',' << dataset << ',' << stations.size() << ',' << connections.size() << ','
+         << times.size() << ',' << fixed << setprecision(4) << median << ',' << times.front() << ',' << times.back() << ','
+         << items << ',' << setprecision(1) << (median > 0 ? items / (median / 1000) : 0) << defaultfloat << '\n';
+    cout.flush();
+}
+
+/** Function that picks fixed, well spread station ids, so every run measures the same queries
+ * @brief Complexity O(k)
+ */
+vector<int> pick_stations(int k) {
+    vector<int> picked;
+    auto n = (uint64_t) stations.size();
+    for (uint64_t i = 0; (int) picked.size() < k && n > 0; i++)
+        picked.push_back(1 + (int) ((i * 2654435761ULL + 12345) % n));
+    return picked;
+}
+
+void bench_dataset(const BenchOptions& options, const BenchDataset& d) {
+    auto noSetup = [] {};
+    auto clearSetup = [] { clear_dataset(); };
+
+    auto readCsv = [&] {
+        read_stations(d.stations_file);
+        read_network(d.network_file);
+    };
+    clear_dataset();
+    readCsv();
+    long numConnections = (long) connections.size();
+
+    measure(options, "load_csv", d.name, numConnections, clearSetup, readCsv);
+
+    string snapshot = options.work + "/" + d.name + ".snap";
+    write_snapshot(snapshot, d.stations_file, d.network_file);
+    measure(options, "load_snapshot", d.name, numConnections, clearSetup, [&] {
+        if (!load_snapshot(snapshot, d.stations_file, d.network_file)) readCsv();
+    });
+
+    vector<int> picked = pick_stations(8);
+    vector<pair<int, int>> pairs;
+    for (size_t i = 0; i + 1 < picked.size(); i += 2)
+        if (picked[i] != picked[i + 1]) pairs.emplace_back(picked[i], picked[i + 1]);
+
+    measure(options, "edmonds_karp", d.name, (long) pairs.size(), noSetup, [&] {
+        for (const auto &p : pairs) maxFlow(p.first, p.second);
+    });
+    measure(options, "super_source", d.name, (long) pairs.size(), noSetup, [&] {
+        for (const auto &p : pairs) superSource(p.second);
+    });
+    measure(options, "dijkstra", d.name, (long) pairs.size(), noSetup, [&] {
+        for (const auto &p : pairs) cheapestRoute(p.first, p.second);
+    });
+    measure(options, "top_k", d.name, 200, noSetup, [&] {
+        for (int i = 0; i < 100; i++) {
+            topRegions(districts, 10);
+            topRegions(municipalities, 10);
+        }
+    });
+    if ((int) stations.size() <= options.mostTrainsLimit) {
+        measure(options, "most_trains", d.name, 1, noSetup, [&] { g.mostTrains(); });
+    }
+}
+
+int main(int argc, char *argv[]) {
+    BenchOptions options;
+    // every run must compute its queries, not find them in the result cache
+    setCacheCapacity(0);
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string arg = argv[i], value = argv[i + 1];
+        if (arg == "--files") options.files = value;
+        else if (arg == "--work") options.work = value;
+        else if (arg == "--repeat") options.repeat = max(1, stoi(value));
+        else if (arg == "--most-trains-limit") options.mostTrainsLimit = stoi(value);
+        else if (arg == "--sizes") {
+            options.sizes.clear();
+            stringstream ss(value);
+            string size;
+            while (getline(ss, size, ',')) if (!size.empty()) options.sizes.push_back(stoi(size));
+        }
+        else {
+            cerr << "Unknown option " << arg << endl;
+            return 1;
+        }
+    }
+
+    filesystem::create_directories(options.work);
+    vector<BenchDataset> datasets = {
+        {"demo", options.files + "/demo_stations.csv", options.files + "/demo_networks.csv"},
+        {"full", options.files + "/stations.csv", options.files + "/network.csv"},
+    };
+    for (int size : options.sizes) {
+        string name = "gen-" + to_string(size);
+        BenchDataset d = {name, options.work + "/" + name + "-stations.csv", options.work + "/" + name + "-network.csv"};
+        GeneratorOptions generator;
+        generator.stations = size;
+        generator.seed = 42;
+        if (!generate_network(generator, d.stations_file, d.network_file)) {
+            cerr << "Could not generate " << name << " in " << options.work << endl;
+            return 1;
+        }
+        datasets.push_back(d);
+    }
+
+    cout << "benchmark,dataset,stations,connections,runs,median_ms,min_ms,max_ms,items,items_per_s\n";
+    for (const auto &d : datasets) {
+        if (!filesystem::exists(d.stations_file) || !filesystem::exists(d.network_file)) {
+            cerr << "Skipping " << d.name << ", missing " << d.stations_file << " or " << d.network_file << endl;
+            continue;
+        }
+        bench_dataset(options, d);
+        clear_dataset();
+    }
+    return 0;
+}
@@ -0,0 +1,474 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "../headers/Batch.h"
+#include "../headers/Dataset.h"
+#include "../headers/Queries.h"
+
+namespace {
+
+/*
+ * Collects the answers and hands them to the stream in large blocks.
+ */
+class BatchWriter {
+public:
+    explicit BatchWriter(ostream &out): out(out) { buffer.reserve(CAPACITY); }
+    ~BatchWriter() { flush(); }
+
+    void write(string_view s) {
+        buffer.append(s.data(), s.size());
+        buffer.push_back('\n');
+        if (buffer.size() >= CAPACITY) flush();
+    }
+
+    void flush() {
+        out.write(buffer.data(), (streamsize) buffer.size());
+        buffer.clear();
+    }
+
+private:
+    static constexpr size_t CAPACITY = 1 << 16;
+    ostream &out;
+    string buffer;
+};
+
+void append_number(string &s, double x) {
+    char number[32];
+    if (x == floor(x) && fabs(x) < 1e15) snprintf(number, sizeof number, "%lld", (long long) x);
+    else snprintf(number, sizeof number, "%g", x);
+    s += number;
+}
+
+void append_name(string &s, int station) {
+    s += stations.find(station)->second.getName();
+}
+
+/*
+ * Looks up the station named in a field, returns -1 and sets the error if there is none.
+ */
+int station_field(const string &field, string &error) {
+    int id = findStation(field);
+    if (id == -1) error = "unknown station " + field;
+    return id;
+}
+
+/*
+ * Reads origin-destination pairs, Station_A,Station_B on each line, adding a message to the errors for every rejected line.
+ * Returns false if the file cannot be opened.
+ */
+bool read_pairs(const string &file, vector<pair<int, int>> &pairs, vector<string> &errors) {
+    ifstream in(file);
+    if (!in) {
+        errors.push_back("cannot open " + file);
+        return false;
+    }
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        size_t comma = line.find(',');
+        string error;
+        if (comma == string::npos) error = "a pair is Station_A,Station_B";
+        int id1 = error.empty() ? station_field(line.substr(0, comma), error) : -1;
+        int id2 = error.empty() ? station_field(line.substr(comma + 1), error) : -1;
+        if (error.empty() && id1 == id2) error = "the stations are the same";
+        if (!error.empty()) errors.push_back("line " + to_string(lineNumber) + ": " + error);
+        else pairs.emplace_back(id1, id2);
+    }
+    return true;
+}
+
+void append_pair(string &s, const pair<int, int> &p) {
+    append_name(s, p.first);
+    s += " to ";
+    append_name(s, p.second);
+}
+
+bool parse_count(const string &field, int &k) {
+    istringstream ss(field);
+    return (ss >> k) && k >= 0;
+}
+
+/*
+ * Reads the optional service filter at a position of the fields, every service if there is none.
+ * Returns false if the filter names an unknown service.
+ */
+bool services_field(const vector<string> &fields, size_t position, unsigned int &services) {
+    services = ALL_SERVICES;
+    return fields.size() <= position || parse_services(fields[position], services);
+}
+
+} // namespace
+
+string answer_query(const string& line, string& response) {
+    vector<string> fields;
+    stringstream ss(line);
+    string field;
+    while (getline(ss, field, ',')) fields.push_back(field);
+    if (fields.empty()) return "empty query";
+
+    const string &type = fields[0];
+    string error;
+    response = line;
+    response += ',';
+
+    if (type == "maxflow" || type == "cheapest" || type == "widest") {
+        unsigned int services;
+        if (fields.size() != 3 && fields.size() != 4) return type + " expects Station_A,Station_B[,Service]";
+        if (!services_field(fields, 3, services)) return "unknown service " + fields[3];
+        int id1 = station_field(fields[1], error);
+        int id2 = station_field(fields[2], error);
+        if (!error.empty()) return error;
+        if (id1 == id2) return "the stations are the same";
+
+        if (type == "maxflow") {
+            append_number(response, maxFlow(id1, id2, services));
+            return "";
+        }
+        if (type == "widest") {
+            vector<int> stations;
+            double trains = widestRoute(id1, id2, stations, services);
+            if (stations.empty()) {
+                response += "unreachable";
+                return "";
+            }
+            append_number(response, trains);
+            response += ',';
+            for (size_t i = 0; i < stations.size(); i++) {
+                if (i > 0) response += ';';
+                append_name(response, stations[i]);
+            }
+            return "";
+        }
+        Route route = cheapestRoute(id1, id2, services);
+        if (route.stations.empty()) {
+            response += "unreachable";
+            return "";
+        }
+        append_number(response, route.trains);
+        response += ',';
+        append_number(response, route.cost);
+        response += ',';
+        for (size_t i = 0; i < route.stations.size(); i++) {
+            if (i > 0) response += ';';
+            append_name(response, route.stations[i]);
+        }
+        return "";
+    }
+
+    if (type == "arrivals") {
+        unsigned int services;
+        if (fields.size() != 2 && fields.size() != 3) return "arrivals expects Station[,Service]";
+        if (!services_field(fields, 2, services)) return "unknown service " + fields[2];
+        int id = station_field(fields[1], error);
+        if (!error.empty()) return error;
+        append_number(response, superSource(id, services));
+        return "";
+    }
+
+    if (type == "top") {
+        int k;
+        if (fields.size() != 3 || (fields[1] != "districts" && fields[1] != "municipalities") || !parse_count(fields[2], k))
+            return "top expects districts|municipalities,K";
+        auto top = topRegions(fields[1] == "districts" ? districts : municipalities, k);
+        for (size_t i = 0; i < top.size(); i++) {
+            if (i > 0) response += ';';
+            response += Station::strings().get(top[i]);
+        }
+        return "";
+    }
+
+    if (type == "topflow") {
+        static const unordered_map<string, RegionKind> kinds = {
+            {"districts", RegionKind::District}, {"municipalities", RegionKind::Municipality},
+            {"townships", RegionKind::Township}, {"lines", RegionKind::Line}};
+        int k;
+        unsigned int services;
+        if ((fields.size() != 3 && fields.size() != 4) || !kinds.count(fields[1]) || !parse_count(fields[2], k))
+            return "topflow expects districts|municipalities|townships|lines,K[,Service]";
+        if (!services_field(fields, 3, services)) return "unknown service " + fields[3];
+        auto top = topRegionsByFlow(kinds.at(fields[1]), k, services);
+        for (size_t i = 0; i < top.size(); i++) {
+            if (i > 0) response += ';';
+            response += Station::strings().get(top[i].first);
+            response += ':';
+            append_number(response, top[i].second);
+        }
+        return "";
+    }
+
+    if (type == "impact") {
+        int k;
+        unsigned int services = ALL_SERVICES;
+        if (fields.size() < 4 || !parse_count(fields[1], k))
+            return "impact expects K[,Service],Station_A,Station_B[,Station_C,Station_D...]";
+        // the stations come in pairs, so a field left over after K is the service
+        size_t first = 2 + fields.size() % 2;
+        if (first == 3 && !services_field(fields, 2, services)) return "unknown service " + fields[2];
+        vector<pair<int, int>> segments;
+        for (size_t i = first; i + 1 < fields.size(); i += 2) {
+            int id1 = station_field(fields[i], error);
+            int id2 = station_field(fields[i + 1], error);
+            if (!error.empty()) return error;
+            if (!hasSegment(id1, id2)) return "no segment between " + fields[i] + " and " + fields[i + 1];
+            segments.emplace_back(id1, id2);
+        }
+
+        auto affected = failureImpact(segments, k, services);
+        for (size_t i = 0; i < affected.size(); i++) {
+            if (i > 0) response += ';';
+            append_name(response, affected[i].first);
+            response += ':';
+            append_number(response, affected[i].second);
+        }
+        return "";
+    }
+
+    if (type == "islands") {
+        if (fields.size() < 3 || fields.size() % 2 != 1)
+            return "islands expects Station_A,Station_B[,Station_C,Station_D...]";
+        vector<pair<int, int>> segments;
+        for (size_t i = 1; i + 1 < fields.size(); i += 2) {
+            int id1 = station_field(fields[i], error);
+            int id2 = station_field(fields[i + 1], error);
+            if (!error.empty()) return error;
+            if (!hasSegment(id1, id2)) return "no segment between " + fields[i] + " and " + fields[i + 1];
+            segments.emplace_back(id1, id2);
+        }
+
+        auto islands = disconnectedStations({segments})[0];
+        for (size_t i = 0; i < islands.size(); i++) {
+            if (i > 0) response += '|';
+            for (size_t j = 0; j < islands[i].size(); j++) {
+                if (j > 0) response += ';';
+                append_name(response, islands[i][j]);
+            }
+        }
+        return "";
+    }
+
+    if (type == "routes") {
+        unsigned int services;
+        if (fields.size() != 3 && fields.size() != 4) return "routes expects Station_A,Station_B[,Service]";
+        if (!services_field(fields, 3, services)) return "unknown service " + fields[3];
+        int id1 = station_field(fields[1], error);
+        int id2 = station_field(fields[2], error);
+        if (!error.empty()) return error;
+        if (id1 == id2) return "the stations are the same";
+
+        vector<double> trains;
+        auto routes = trainRoutes(id1, id2, trains, services);
+        for (size_t i = 0; i < routes.size(); i++) {
+            if (i > 0) response += '|';
+            append_number(response, trains[i]);
+            response += ':';
+            for (size_t j = 0; j < routes[i].size(); j++) {
+                if (j > 0) response += ';';
+                append_name(response, routes[i][j]);
+            }
+        }
+        return "";
+    }
+
+    if (type == "upgrades") {
+        int k, extra;
+        unsigned int services;
+        if ((fields.size() != 5 && fields.size() != 6) || !parse_count(fields[1], k) || !parse_count(fields[2], extra))
+            return "upgrades expects K,Extra,Station_A,Station_B[,Service]";
+        if (!services_field(fields, 5, services)) return "unknown service " + fields[5];
+        int id1 = station_field(fields[3], error);
+        int id2 = station_field(fields[4], error);
+        if (!error.empty()) return error;
+        if (id1 == id2) return "the stations are the same";
+
+        double flow;
+        auto upgrades = upgradeGains(id1, id2, extra, k, flow, services);
+        append_number(response, flow);
+        response += ',';
+        for (size_t i = 0; i < upgrades.size() && i < (size_t) k; i++) {
+            if (i > 0) response += ';';
+            append_pair(response, {upgrades[i].station1, upgrades[i].station2});
+            response += ':';
+            append_number(response, upgrades[i].gain);
+        }
+        return "";
+    }
+
+    if (type == "mincut") {
+        int seed = 0;
+        unsigned int services = ALL_SERVICES;
+        bool randomized = false, filtered = false;
+        // a seed is a number and a service a name, so either one can be left out
+        for (size_t i = 1; i < fields.size(); i++) {
+            if (i == 1 && parse_count(fields[i], seed)) randomized = true;
+            else if (!filtered && parse_services(fields[i], services)) filtered = true;
+            else return "mincut expects [Seed][,Service], a seed runs the randomized cut";
+        }
+        auto cuts = weakestCuts(randomized, (uint64_t) seed, services);
+        for (size_t i = 0; i < cuts.size(); i++) {
+            if (i > 0) response += '|';
+            append_name(response, cuts[i].stations.front());
+            response += ':';
+            response += to_string(cuts[i].stations.size());
+            response += ':';
+            append_number(response, cuts[i].capacity);
+            response += ':';
+            for (size_t j = 0; j < cuts[i].segments.size(); j++) {
+                if (j > 0) response += ';';
+                append_pair(response, cuts[i].segments[j]);
+            }
+        }
+        return "";
+    }
+
+    if (type == "cache") {
+        if (fields.size() != 1) return "cache expects no arguments";
+        CacheStats stats = cacheStats();
+        response = "cache,";
+        append_number(response, (double) stats.hits);
+        response += ',';
+        append_number(response, (double) stats.misses);
+        response += ',';
+        append_number(response, (double) stats.entries);
+        return "";
+    }
+
+    return "unknown query " + type;
+}
+
+BatchResult run_batch(istream& in, ostream& out) {
+    BatchResult result;
+    BatchWriter writer(out);
+    string line, response;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        string error = answer_query(line, response);
+        if (error.empty()) {
+            result.answered++;
+            writer.write(response);
+            continue;
+        }
+        result.errors.push_back("line " + to_string(lineNumber) + ": " + error);
+        writer.write("error," + to_string(lineNumber) + "," + error);
+    }
+    return result;
+}
+
+BatchResult run_batch_file(const string& queries_file, const string& output_file) {
+    ifstream in(queries_file);
+    if (!in) {
+        BatchResult result;
+        result.errors.push_back("cannot open " + queries_file);
+        return result;
+    }
+    if (output_file.empty()) return run_batch(in, cout);
+
+    ofstream out(output_file);
+    if (!out) {
+        BatchResult result;
+        result.errors.push_back("cannot write " + output_file);
+        return result;
+    }
+    return run_batch(in, out);
+}
+
+BatchResult run_sweep_file(const string& pairs_file, const string& report_file, int threads, unsigned int services) {
+    BatchResult result;
+    vector<pair<int, int>> pairs;
+    if (!pairs_file.empty() && !read_pairs(pairs_file, pairs, result.errors)) return result;
+
+    ofstream file;
+    if (!report_file.empty()) {
+        file.open(report_file);
+        if (!file) {
+            result.errors.push_back("cannot write " + report_file);
+            return result;
+        }
+    }
+    BatchWriter writer(report_file.empty() ? cout : file);
+
+    string row = "Rank,Station_A,Station_B,Stations_Affected,Arrivals_Lost,Worst_Station,Worst_Loss,Pairs_Lost";
+    for (const auto &p : pairs) {
+        row += ',';
+        append_pair(row, p);
+    }
+    writer.write(row);
+
+    for (const auto &c : contingencySweep(pairs, threads, services)) {
+        row = to_string(++result.answered) + ',';
+        append_name(row, c.station1);
+        row += ',';
+        append_name(row, c.station2);
+        row += ',' + to_string(c.affected) + ',';
+        append_number(row, c.lost);
+        row += ',';
+        if (c.worst != -1) append_name(row, c.worst);
+        row += ',';
+        append_number(row, c.worstLoss);
+        row += ',';
+        append_number(row, c.pairsLost);
+        for (double loss : c.pairLosses) {
+            row += ',';
+            append_number(row, loss);
+        }
+        writer.write(row);
+    }
+    return result;
+}
+
+BatchResult run_reliability_file(const string& pairs_file, const string& report_file, const ReliabilityOptions& options,
+                                 unsigned int services) {
+    BatchResult result;
+    vector<pair<int, int>> pairs;
+    if (!read_pairs(pairs_file, pairs, result.errors)) return result;
+    if (pairs.empty()) {
+        result.errors.push_back("no pairs in " + pairs_file);
+        return result;
+    }
+
+    ofstream file;
+    if (!report_file.empty()) {
+        file.open(report_file);
+        if (!file) {
+            result.errors.push_back("cannot write " + report_file);
+            return result;
+        }
+    }
+    BatchWriter writer(report_file.empty() ? cout : file);
+
+    ReliabilityReport report = simulateFailures(pairs, options, services);
+    writer.write("Station_A,Station_B,Baseline,Mean,Deviation,Margin,P5,P50,P95,No_Flow");
+    for (const auto &r : report.pairs) {
+        string row;
+        append_name(row, r.source);
+        row += ',';
+        append_name(row, r.target);
+        for (double x : {r.baseline, r.mean, r.deviation, r.margin, r.p5, r.p50, r.p95, r.noFlow}) {
+            row += ',';
+            append_number(row, x);
+        }
+        writer.write(row);
+        result.answered++;
+    }
+
+    string line = "# " + to_string(report.scenarios) + " scenarios, " + (report.converged ? "converged" : "not converged");
+    writer.write(line);
+    for (const auto &t : report.trace) {
+        line = "# after " + to_string(t.first) + " scenarios the widest margin is ";
+        append_number(line, t.second);
+        writer.write(line);
+    }
+    return result;
+}
@@ -0,0 +1,206 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "../headers/Dataset.h"
+#include "../headers/Snapshot.h"
+
+Graph g;
+
+unordered_map<int, Station> stations;
+
+unordered_map<uint32_t, int> stations_name;
+
+unordered_map<int, edge> connections;
+
+unordered_map<uint32_t, int> districts;
+
+unordered_map<uint32_t, int> municipalities;
+
+void read_stations(const string& file){
+    ifstream stations_file(file);
+
+    string line;
+
+    int i = 1;
+    getline(stations_file, line);
+    while(getline(stations_file, line)){
+        stringstream ss(line);
+        string name, district, municipality, township, tline, capacity;
+        getline(ss, name, ',');
+        getline(ss, district, ',');
+        getline(ss, municipality, ',');
+        getline(ss, township, ',');
+        getline(ss, tline, ',');
+        getline(ss, capacity, ',');
+
+        Station station(name, district, municipality, township, tline);
+        stations.insert({i, station});
+        stations_name.insert({station.getNameId(), i});
+        municipalities.insert({station.getMunicipalityId(), 0});
+        districts.insert({station.getDistrictId(), 0});
+
+        g.addVertex(i);
+        // an optional last column limits the trains the station can pass per time unit
+        int limit;
+        auto [end, ec] = from_chars(capacity.data(), capacity.data() + capacity.size(), limit);
+        if (ec == errc() && limit >= 0) g.setVertexCapacity(i, limit);
+
+        i++;
+    }
+}
+
+namespace {
+
+/** Files smaller than this are parsed on the calling thread, spawning workers would cost more than it saves */
+const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+/** Connection parsed from one line of the network file, before it gets its id */
+struct ParsedConnection {
+    int id1, id2, capacity;
+    string service;
+    bool valid;
+};
+
+/** Result of parsing one chunk of the network file, with the chunk's partial capacity sums per district and municipality */
+struct NetworkChunk {
+    vector<ParsedConnection> connections;
+    unordered_map<uint32_t, int> districtTotals;
+    unordered_map<uint32_t, int> municipalityTotals;
+};
+
+/*
+ * Parses the lines in [begin, end), which must start at a line boundary. Only reads the stations,
+ * so any number of chunks can be parsed at the same time.
+ */
+void parse_network_chunk(const char *begin, const char *end, NetworkChunk &chunk) {
+    while (begin < end) {
+        const char *eol = find(begin, end, '\n');
+        string_view line(begin, eol - begin);
+        begin = eol == end ? end : eol + 1;
+
+        ParsedConnection c{-1, -1, 0, "", false};
+        size_t comma1 = line.find(',');
+        size_t comma2 = comma1 == string_view::npos ? string_view::npos : line.find(',', comma1 + 1);
+        if (comma2 != string_view::npos) {
+            c.id1 = findStation(line.substr(0, comma1));
+            c.id2 = findStation(line.substr(comma1 + 1, comma2 - comma1 - 1));
+            const char *capBegin = line.data() + comma2 + 1;
+            auto [capEnd, ec] = from_chars(capBegin, line.data() + line.size(), c.capacity);
+            if (ec == errc() && c.id1 != -1 && c.id2 != -1) {
+                string_view rest = line.substr(min(line.size(), (size_t) (capEnd - line.data()) + 1));
+                c.service = string(rest.substr(0, rest.find(',')));
+                c.valid = true;
+
+                const Station &s1 = stations.find(c.id1)->second;
+                const Station &s2 = stations.find(c.id2)->second;
+                chunk.districtTotals[s1.getDistrictId()] += c.capacity;
+                chunk.districtTotals[s2.getDistrictId()] += c.capacity;
+                chunk.municipalityTotals[s1.getMunicipalityId()] += c.capacity;
+                chunk.municipalityTotals[s2.getMunicipalityId()] += c.capacity;
+            }
+        }
+        chunk.connections.push_back(std::move(c));
+    }
+}
+
+} // namespace
+
+void read_network(const string& file){
+
+    ifstream network_file(file, ios::binary);
+    string content((istreambuf_iterator<char>(network_file)), istreambuf_iterator<char>());
+
+    // Skip the header
+    size_t start = content.find('\n');
+    start = start == string::npos ? content.size() : start + 1;
+    const char *data = content.data();
+    size_t size = content.size() - start;
+
+    // Split at line boundaries, one chunk per worker
+    unsigned workers = max(1u, min(thread::hardware_concurrency(), (unsigned) (size / MIN_CHUNK_BYTES)));
+    vector<const char *> bounds = {data + start};
+    for (unsigned k = 1; k < workers; k++) {
+        const char *p = data + start + size * k / workers;
+        p = max(p, bounds.back());
+        const char *eol = find(p, data + content.size(), '\n');
+        bounds.push_back(eol == data + content.size() ? eol : eol + 1);
+    }
+    bounds.push_back(data + content.size());
+
+    vector<NetworkChunk> chunks(workers);
+    if (workers == 1) {
+        parse_network_chunk(bounds[0], bounds[1], chunks[0]);
+    } else {
+        vector<thread> threads;
+        for (unsigned k = 0; k < workers; k++)
+            threads.emplace_back(parse_network_chunk, bounds[k], bounds[k + 1], ref(chunks[k]));
+        for (auto &t : threads) t.join();
+    }
+
+    // Merge in file order, so every connection keeps the id of its line
+    int i = 1;
+    for (auto &chunk : chunks) {
+        for (auto &c : chunk.connections) {
+            if (c.valid) {
+                g.addBidirectionalEdge(c.id1, c.id2, c.capacity, service_price(c.service), service_mask(c.service));
+                edge temp = {{c.id1, c.id2}, {c.capacity, std::move(c.service)}};
+                connections.insert({i, temp});
+            }
+            i++;
+        }
+        for (const auto &d : chunk.districtTotals) districts[d.first] += d.second;
+        for (const auto &m : chunk.municipalityTotals) municipalities[m.first] += m.second;
+    }
+}
+
+void load_dataset(const string& stations_file, const string& network_file) {
+    string snapshot = snapshot_path(network_file);
+    if (load_snapshot(snapshot, stations_file, network_file)) return;
+
+    read_stations(stations_file);
+    read_network(network_file);
+    write_snapshot(snapshot, stations_file, network_file);
+}
+
+void clear_dataset() {
+    g.clear();
+    stations.clear();
+    stations_name.clear();
+    connections.clear();
+    districts.clear();
+    municipalities.clear();
+    Station::strings().clear();
+}
+
+int service_price(string_view service) {
+    return service == "STANDARD" ? 2 : 4;
+}
+
+unsigned int service_mask(string_view service) {
+    if (service == "STANDARD") return 1;
+    return service == "ALFA PENDULAR" ? 2 : 4;
+}
+
+bool parse_services(string_view field, unsigned int &services) {
+    services = 0;
+    while (true) {
+        size_t plus = field.find('+');
+        string_view name = field.substr(0, plus);
+        if (name != "STANDARD" && name != "ALFA PENDULAR") return false;
+        services |= service_mask(name);
+        if (plus == string_view::npos) return true;
+        field.remove_prefix(plus + 1);
+    }
+}
+
+int findStation(string_view name) {
+    auto it = stations_name.find(Station::strings().find(name));
+    return it == stations_name.end() ? -1 : it->second;
+}
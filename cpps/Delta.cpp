@@ -0,0 +1,164 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <fstream>
+#include <sstream>
+#include "../headers/Delta.h"
+#include "../headers/Dataset.h"
+
+namespace {
+
+/*
+ * Finds a connection between two stations, in either direction. Returns its id, or -1.
+ */
+int find_connection(int id1, int id2) {
+    for (const auto &c : connections) {
+        auto ends = c.second.first;
+        if ((ends.first == id1 && ends.second == id2) || (ends.first == id2 && ends.second == id1))
+            return c.first;
+    }
+    return -1;
+}
+
+/*
+ * Rebuilds the graph edges between two stations from the connections map.
+ * Vertex::removeEdge drops every parallel edge at once, so the remaining ones are added back.
+ */
+void relink(int id1, int id2) {
+    g.removeEdge(id1, id2);
+    g.removeEdge(id2, id1);
+    for (const auto &c : connections) {
+        auto ends = c.second.first;
+        if ((ends.first == id1 && ends.second == id2) || (ends.first == id2 && ends.second == id1))
+            g.addBidirectionalEdge(ends.first, ends.second, c.second.second.first, service_price(c.second.second.second),
+                                  service_mask(c.second.second.second));
+    }
+}
+
+/*
+ * Adds a capacity change to the totals of the district and municipality of a station.
+ */
+void adjust_totals(DeltaEffect &effect, int station, int capacity) {
+    const Station &s = stations.find(station)->second;
+    districts[s.getDistrictId()] += capacity;
+    municipalities[s.getMunicipalityId()] += capacity;
+    effect.stations.insert(station);
+    effect.districts.insert(s.getDistrictId());
+    effect.municipalities.insert(s.getMunicipalityId());
+}
+
+bool parse_capacity(const string &field, int &capacity) {
+    istringstream ss(field);
+    return (ss >> capacity) && capacity >= 0;
+}
+
+/*
+ * Applies one update, returns an error message or an empty string.
+ */
+string apply_update(const vector<string> &fields, DeltaEffect &effect) {
+    const string &op = fields[0];
+
+    if (op == "add_station") {
+        int limit = -1;
+        if ((fields.size() != 6 && fields.size() != 7) || (fields.size() == 7 && !parse_capacity(fields[6], limit)))
+            return "add_station expects Name,District,Municipality,Township,Line[,Capacity]";
+        if (findStation(fields[1]) != -1) return "station " + fields[1] + " already exists";
+        int id = 1;
+        for (const auto &s : stations) id = max(id, s.first + 1);
+        Station station(fields[1], fields[2], fields[3], fields[4], fields[5]);
+        stations.insert({id, station});
+        stations_name.insert({station.getNameId(), id});
+        districts.insert({station.getDistrictId(), 0});
+        municipalities.insert({station.getMunicipalityId(), 0});
+        g.addVertex(id);
+        if (limit != -1) g.setVertexCapacity(id, limit);
+        effect.stations.insert(id);
+        return "";
+    }
+
+    if (op != "add_segment" && op != "remove_segment" && op != "modify_segment") return "unknown update " + op;
+    if (fields.size() < 3) return op + " expects Station_A,Station_B";
+    int id1 = findStation(fields[1]);
+    int id2 = findStation(fields[2]);
+    if (id1 == -1) return "station " + fields[1] + " does not exist";
+    if (id2 == -1) return "station " + fields[2] + " does not exist";
+    if (id1 == id2) return "a segment needs two different stations";
+
+    if (op == "add_segment") {
+        int capacity;
+        if (fields.size() != 5 || !parse_capacity(fields[3], capacity)) return "add_segment expects Station_A,Station_B,Capacity,Service";
+        int id = 1;
+        for (const auto &c : connections) id = max(id, c.first + 1);
+        edge temp = {{id1, id2}, {capacity, fields[4]}};
+        connections.insert({id, temp});
+        g.addBidirectionalEdge(id1, id2, capacity, service_price(fields[4]), service_mask(fields[4]));
+        effect.segments.emplace_back(id1, id2);
+        adjust_totals(effect, id1, capacity);
+        adjust_totals(effect, id2, capacity);
+        return "";
+    }
+
+    int id = find_connection(id1, id2);
+    if (id == -1) return "there is no connection between " + fields[1] + " and " + fields[2];
+    auto &con = connections.find(id)->second;
+
+    if (op == "remove_segment") {
+        if (fields.size() != 3) return "remove_segment expects Station_A,Station_B";
+        int capacity = con.second.first;
+        connections.erase(id);
+        relink(id1, id2);
+        effect.segments.emplace_back(id1, id2);
+        adjust_totals(effect, id1, -capacity);
+        adjust_totals(effect, id2, -capacity);
+        return "";
+    }
+
+    int capacity;
+    if ((fields.size() != 4 && fields.size() != 5) || !parse_capacity(fields[3], capacity))
+        return "modify_segment expects Station_A,Station_B,Capacity[,Service]";
+    int change = capacity - con.second.first;
+    con.second.first = capacity;
+    if (fields.size() == 5) con.second.second = fields[4];
+    relink(id1, id2);
+    effect.segments.emplace_back(id1, id2);
+    adjust_totals(effect, id1, change);
+    adjust_totals(effect, id2, change);
+    return "";
+}
+
+} // namespace
+
+DeltaEffect apply_delta(istream& in) {
+    DeltaEffect effect;
+    effect.before = g.getVersion();
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, ',')) fields.push_back(field);
+
+        string error = apply_update(fields, effect);
+        if (error.empty()) effect.applied++;
+        else effect.errors.push_back("line " + to_string(lineNumber) + ": " + error);
+    }
+    effect.after = g.getVersion();
+    return effect;
+}
+
+DeltaEffect apply_delta_file(const string& file) {
+    ifstream in(file);
+    if (!in) {
+        DeltaEffect effect;
+        effect.before = effect.after = g.getVersion();
+        effect.errors.push_back("cannot open " + file);
+        return effect;
+    }
+    return apply_delta(in);
+}
@@ -0,0 +1,247 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+#include "../headers/NetworkGenerator.h"
+
+namespace {
+
+/*
+ * splitmix64, used instead of <random> because the standard distributions are not
+ * required to give the same numbers on every library, and the files must be reproducible.
+ */
+class Random {
+public:
+    explicit Random(uint64_t seed): state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    double uniform() {
+        return (double) (next() >> 11) * 0x1.0p-53;
+    }
+
+    int below(int n) {
+        return std::min(n - 1, (int) (uniform() * n));
+    }
+
+    bool chance(double p) {
+        return uniform() < p;
+    }
+
+private:
+    uint64_t state;
+};
+
+struct Point {
+    double x, y;
+};
+
+struct GeneratedStation {
+    Point at;
+    int line;
+};
+
+struct GeneratedSegment {
+    int a, b, capacity;
+    bool alfa;
+};
+
+/*
+ * Uniform grid over the unit square, for nearest-hub queries without an O(H^2) scan.
+ */
+class HubGrid {
+public:
+    HubGrid(const vector<Point> &points, int expected): points(points) {
+        side = std::max(1, (int) std::sqrt(expected / 2.0));
+        cells.resize((size_t) side * side);
+    }
+
+    void insert(int hub) {
+        cells[cellOf(points[hub])].push_back(hub);
+    }
+
+    /*
+     * Nearest inserted hub accepted by the filter, or -1. Searches rings of cells around the point
+     * and stops once the next ring is farther than the best hub found.
+     */
+    int nearest(const Point &p, const function<bool(int)> &accept) const {
+        int cx = coord(p.x), cy = coord(p.y);
+        int best = -1;
+        double bestDist = INFINITY;
+        for (int r = 0; r < side; r++) {
+            if (best != -1 && (r - 1) / (double) side > std::sqrt(bestDist)) break;
+            for (int x = cx - r; x <= cx + r; x++) {
+                for (int y = cy - r; y <= cy + r; y++) {
+                    if (std::max(std::abs(x - cx), std::abs(y - cy)) != r) continue;
+                    if (x < 0 || y < 0 || x >= side || y >= side) continue;
+                    for (int h : cells[(size_t) x * side + y]) {
+                        double dx = points[h].x - p.x, dy = points[h].y - p.y;
+                        double d = dx * dx + dy * dy;
+                        if (d < bestDist && accept(h)) {
+                            bestDist = d;
+                            best = h;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    const vector<Point> &points;
+    int side;
+    vector<vector<int>> cells;
+
+    int coord(double v) const {
+        return std::min(side - 1, std::max(0, (int) (v * side)));
+    }
+
+    size_t cellOf(const Point &p) const {
+        return (size_t) coord(p.x) * side + coord(p.y);
+    }
+};
+
+double clamp01(double v) {
+    return std::min(0.999999, std::max(0.0, v));
+}
+
+int region(const Point &p, int side) {
+    return std::min(side - 1, (int) (p.x * side)) * side + std::min(side - 1, (int) (p.y * side));
+}
+
+uint64_t pairKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return ((uint64_t) a << 32) | (uint32_t) b;
+}
+
+} // namespace
+
+bool generate_network(const GeneratorOptions& options, const string& stations_file, const string& network_file) {
+    Random rng(options.seed);
+    int n = std::max(2, options.stations);
+    int numHubs = std::max(2, n / 25);
+    int numBranch = std::min(n / 10, n - numHubs);
+    int numIntermediate = n - numHubs - numBranch;
+
+    vector<GeneratedStation> generated;
+    vector<GeneratedSegment> segments;
+    generated.reserve(n);
+
+    // Junction hubs, each linked to its nearest earlier hub so the network is connected
+    vector<Point> hubs(numHubs);
+    for (auto &h : hubs) h = {rng.uniform(), rng.uniform()};
+    for (int i = 0; i < numHubs; i++) generated.push_back({hubs[i], -1});
+
+    HubGrid grid(hubs, numHubs);
+    vector<pair<int, int>> links;
+    unordered_set<uint64_t> linked;
+    grid.insert(0);
+    for (int i = 1; i < numHubs; i++) {
+        int j = grid.nearest(hubs[i], [](int) { return true; });
+        links.emplace_back(j, i);
+        linked.insert(pairKey(i, j));
+        grid.insert(i);
+    }
+    // A few extra links close loops, like the alternative routes of a real network
+    for (int i = 0; i < numHubs; i++) {
+        if (!rng.chance(0.3)) continue;
+        int j = grid.nearest(hubs[i], [&](int h) { return h != i && linked.count(pairKey(i, h)) == 0; });
+        if (j == -1) continue;
+        links.emplace_back(i, j);
+        linked.insert(pairKey(i, j));
+    }
+
+    // Intermediate stations are shared out by link length, so long links become long lines
+    vector<double> lengths;
+    double totalLength = 0;
+    for (const auto &l : links) {
+        double d = std::hypot(hubs[l.first].x - hubs[l.second].x, hubs[l.first].y - hubs[l.second].y);
+        lengths.push_back(d);
+        totalLength += d;
+    }
+    const int capacities[] = {4, 6, 6, 8, 8, 10};
+    double cumulative = 0;
+    long placed = 0;
+    for (size_t li = 0; li < links.size(); li++) {
+        cumulative += totalLength > 0 ? lengths[li] / totalLength : 1.0 / (double) links.size();
+        long upTo = std::lround(cumulative * numIntermediate);
+        int k = (int) std::max(0L, std::min((long) numIntermediate, upTo) - placed);
+        placed += k;
+
+        int line = (int) li;
+        int u = links[li].first, v = links[li].second;
+        if (generated[u].line == -1) generated[u].line = line;
+        if (generated[v].line == -1) generated[v].line = line;
+        int capacity = capacities[rng.below(6)];
+        bool alfa = rng.chance(options.alfaShare);
+
+        int prev = u;
+        for (int s = 1; s <= k + 1; s++) {
+            int next = v;
+            if (s <= k) {
+                double t = (double) s / (k + 1);
+                Point p = {clamp01(hubs[u].x + (hubs[v].x - hubs[u].x) * t + (rng.uniform() - 0.5) * 0.002),
+                           clamp01(hubs[u].y + (hubs[v].y - hubs[u].y) * t + (rng.uniform() - 0.5) * 0.002)};
+                next = (int) generated.size();
+                generated.push_back({p, line});
+            }
+            // Now and then a segment is a bottleneck of its line
+            int c = rng.chance(0.1) ? std::max(2, capacity - 2) : capacity;
+            segments.push_back({prev, next, c, alfa});
+            prev = next;
+        }
+    }
+
+    // Dead-end branch lines hanging off random hubs
+    int line = (int) links.size();
+    double step = 0.3 / std::sqrt((double) numHubs);
+    for (int remaining = numBranch; remaining > 0; line++) {
+        int hub = rng.below(numHubs);
+        int length = std::min(remaining, 1 + rng.below(8));
+        remaining -= length;
+        double angle = rng.uniform() * 6.283185307179586;
+        int capacity = 2 + 2 * rng.below(3);
+        int prev = hub;
+        for (int s = 1; s <= length; s++) {
+            Point p = {clamp01(hubs[hub].x + std::cos(angle) * step * s), clamp01(hubs[hub].y + std::sin(angle) * step * s)};
+            int next = (int) generated.size();
+            generated.push_back({p, line});
+            segments.push_back({prev, next, capacity, false});
+            prev = next;
+        }
+    }
+
+    // Districts, municipalities and townships are nested grids over the map
+    int districtSide = std::max(1, (int) std::ceil(std::sqrt(std::max(2.0, std::sqrt((double) n) * 0.8))));
+    ofstream stations_out(stations_file);
+    if (!stations_out) return false;
+    stations_out << "Name,District,Municipality,Township,Line\n";
+    for (size_t i = 0; i < generated.size(); i++) {
+        const auto &s = generated[i];
+        stations_out << "Station " << i + 1
+                     << ",DISTRICT " << region(s.at, districtSide) + 1
+                     << ",MUNICIPALITY " << region(s.at, districtSide * 3) + 1
+                     << ",Township " << region(s.at, districtSide * 9) + 1
+                     << ",Linha " << std::max(0, s.line) + 1 << '\n';
+    }
+
+    ofstream network_out(network_file);
+    if (!network_out) return false;
+    network_out << "Station_A,Station_B,Capacity,Service\n";
+    for (const auto &s : segments)
+        network_out << "Station " << s.a + 1 << ",Station " << s.b + 1 << ',' << s.capacity << ',' << (s.alfa ? "ALFA PENDULAR" : "STANDARD") << '\n';
+
+    return stations_out.good() && network_out.good();
+}
@@ -0,0 +1,755 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include "../headers/Queries.h"
+#include "../headers/Dataset.h"
+#include "../DataStructures/ArrivalsIndex.h"
+#include "../DataStructures/BlockCutTree.h"
+#include "../DataStructures/CapacitySensitivity.h"
+#include "../DataStructures/FailureConnectivity.h"
+#include "../DataStructures/GlobalMinCut.h"
+#include "../DataStructures/GraphStats.h"
+#include "../DataStructures/Heap.h"
+#include "../DataStructures/LruCache.h"
+#include "../DataStructures/WidestPaths.h"
+
+namespace {
+
+enum QueryType { MAX_FLOW, ARRIVALS, CHEAPEST, BLOCK_FLOW };
+
+/*
+ * A query, with the services it may use. Its result holds on the graph the cache was last brought up to date with.
+ */
+struct QueryKey {
+    int type, source, target;
+    unsigned int services;
+
+    bool operator==(const QueryKey &other) const {
+        return type == other.type && source == other.source && target == other.target && services == other.services;
+    }
+};
+
+struct QueryKeyHash {
+    size_t operator()(const QueryKey &key) const {
+        size_t h = (size_t) key.type;
+        h = h * 1000003 + (size_t) key.source;
+        h = h * 1000003 + (size_t) key.target;
+        h = h * 31 + (size_t) key.services;
+        return h;
+    }
+};
+
+const size_t DEFAULT_CACHE_ENTRIES = 4096;
+
+mutex cacheLock;
+LruCache<QueryKey, double, QueryKeyHash> flowCache(DEFAULT_CACHE_ENTRIES);
+LruCache<QueryKey, Route, QueryKeyHash> routeCache(DEFAULT_CACHE_ENTRIES);
+
+/*
+ * Copies of the loaded graph for the queries that keep to one mask of services: the flat network with only the segments
+ * of those services, its chains of stations, its blocks and its widest routes.
+ */
+struct ServiceNetwork {
+    shared_ptr<const Contraction> contraction;
+    shared_ptr<const BlockCutTree> blocks;
+    shared_ptr<const WidestPaths> widest;
+};
+
+mutex networkLock;
+unordered_map<unsigned int, ServiceNetwork> networks;   // mask of services -> its copies, ALL_SERVICES for the whole graph
+unsigned long networkVersion = 0;
+unsigned long resultsVersion = 0;                       // version of the graph the cached results and memos hold for
+
+// every thread runs the algorithms in its own working memory
+thread_local FlowScratch scratch, coreScratch;
+
+void forget_results();
+
+/*
+ * Copies of the loaded graph for a mask of services, built the first time the mask is asked for on a version of the graph.
+ * A change to the graph that forgetChanges was not told about drops every cached result.
+ * Must be called with networkLock held.
+ */
+const ServiceNetwork &refresh_network(unsigned int services) {
+    if (networkVersion != g.getVersion()) {
+        networks.clear();
+        networkVersion = g.getVersion();
+    }
+    if (resultsVersion != g.getVersion()) {
+        forget_results();
+        resultsVersion = g.getVersion();
+    }
+    ServiceNetwork &copies = networks[services];
+    if (copies.contraction != nullptr) return copies;
+    shared_ptr<const FlowNetwork> flat;
+    if (services == ALL_SERVICES) flat = make_shared<const FlowNetwork>(g);
+    else flat = make_shared<const FlowNetwork>(refresh_network(ALL_SERVICES).contraction->getNetwork(), services);
+    copies.contraction = make_shared<const Contraction>(flat);
+    copies.blocks = make_shared<const BlockCutTree>(flat);
+    copies.widest = make_shared<const WidestPaths>(flat);
+    return copies;
+}
+
+/*
+ * Flat copy of the loaded graph, with only the segments of some services, and its chains of stations.
+ */
+shared_ptr<const Contraction> current_contraction(unsigned int services) {
+    lock_guard<mutex> guard(networkLock);
+    return refresh_network(services).contraction;
+}
+
+/*
+ * Blocks of the loaded graph, see current_contraction.
+ */
+shared_ptr<const BlockCutTree> current_blocks(unsigned int services) {
+    lock_guard<mutex> guard(networkLock);
+    return refresh_network(services).blocks;
+}
+
+/*
+ * Maximum spanning forest of the loaded graph, see current_contraction.
+ */
+shared_ptr<const WidestPaths> current_widest(unsigned int services) {
+    lock_guard<mutex> guard(networkLock);
+    return refresh_network(services).widest;
+}
+
+/*
+ * Flat copy of the loaded graph, see current_contraction.
+ */
+shared_ptr<const FlowNetwork> current_network(unsigned int services) {
+    auto contraction = current_contraction(services);
+    return shared_ptr<const FlowNetwork>(contraction, &contraction->getNetwork());
+}
+
+template <class V>
+bool cached(LruCache<QueryKey, V, QueryKeyHash> &cache, const QueryKey &key, V &value) {
+    lock_guard<mutex> guard(cacheLock);
+    bool hit = cache.get(key, value);
+    if (hit) STATS_ADD(cacheHits, 1);
+    else STATS_ADD(cacheMisses, 1);
+    return hit;
+}
+
+template <class V>
+void remember(LruCache<QueryKey, V, QueryKeyHash> &cache, const QueryKey &key, const V &value) {
+    lock_guard<mutex> guard(cacheLock);
+    cache.put(key, value);
+}
+
+/*
+ * Max flow across a block between two of its stations, shared by every query that crosses the block that way.
+ */
+double block_flow(const BlockCutTree &tree, const BlockCutTree::Hop &hop, unsigned int services) {
+    QueryKey key = {BLOCK_FLOW, hop.from, hop.to, services};
+    double flow;
+    if (cached(flowCache, key, flow)) return flow;
+    flow = tree.blockFlow(hop, coreScratch);
+    remember(flowCache, key, flow);
+    return flow;
+}
+
+/*
+ * Max flow into every region of a kind, the last computed for each kind and mask of services, and the stations changed
+ * since then whose connected parts have to be computed again.
+ */
+struct RegionFlows {
+    bool computed = false;
+    vector<int> changed;
+    vector<pair<uint32_t, double>> flows;
+};
+
+mutex regionLock;
+unordered_map<unsigned int, RegionFlows> regionFlows[4];     // by kind, then by mask of services
+
+uint32_t region_of(const Station &s, RegionKind kind) {
+    switch (kind) {
+        case RegionKind::District: return s.getDistrictId();
+        case RegionKind::Municipality: return s.getMunicipalityId();
+        case RegionKind::Township: return s.getTownshipId();
+        default: return s.getTlineId();
+    }
+}
+
+/*
+ * Calls work(i, scratch) for every i below count, spreading them over threads that each have their own working memory.
+ */
+void parallel_for(size_t count, int threads, const function<void(size_t, FlowScratch &)> &work) {
+    atomic<size_t> next(0);
+    auto run = [&] {
+        FlowScratch local;
+        for (size_t i = next++; i < count; i = next++) work(i, local);
+    };
+    size_t workers = min((size_t) max(1, threads), max((size_t) 1, count));
+    vector<thread> pool;
+    for (size_t t = 1; t < workers; t++) pool.emplace_back(run);
+    run();
+    for (auto &w : pool) w.join();
+}
+
+/*
+ * Every segment of the loaded network that a copy of it kept, once, whatever its direction and number of connections, by ids.
+ */
+vector<pair<int, int>> all_segments(const FlowNetwork &net) {
+    vector<pair<int, int>> segments;
+    for (const auto &c : connections) {
+        int id1 = c.second.first.first, id2 = c.second.first.second;
+        if (net.adjacent(id1, id2)) segments.emplace_back(min(id1, id2), max(id1, id2));
+    }
+    sort(segments.begin(), segments.end());
+    segments.erase(unique(segments.begin(), segments.end()), segments.end());
+    return segments;
+}
+
+/*
+ * Blocks crossed by each pair of stations. The max flow of a pair can only change when a segment of one of them closes.
+ */
+vector<vector<int>> crossed_blocks(const BlockCutTree &tree, const vector<pair<int, int>> &pairs) {
+    vector<vector<int>> crossed(pairs.size());
+    vector<BlockCutTree::Hop> hops;
+    for (size_t p = 0; p < pairs.size(); p++) {
+        tree.route(pairs[p].first, pairs[p].second, hops);
+        for (const auto &hop : hops) crossed[p].push_back(hop.block);
+    }
+    return crossed;
+}
+
+/*
+ * Number in [0, 1) that depends only on the seed, the scenario and the segment (SplitMix64 mixing of the three counters),
+ * so a scenario draws the same failures on any thread and in any order.
+ */
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+double counter_uniform(uint64_t seed, uint64_t scenario, uint64_t segment) {
+    return (double) (mix(mix(mix(seed) ^ scenario) ^ segment) >> 11) * 0x1.0p-53;
+}
+
+/*
+ * Value that a fraction of the sorted values do not exceed (nearest rank).
+ */
+double percentile(const vector<double> &sorted, double fraction) {
+    size_t rank = (size_t) ceil(fraction * (double) sorted.size());
+    return sorted[min(sorted.size(), max((size_t) 1, rank)) - 1];
+}
+
+/*
+ * Computes the max flow into every region of a kind, spreading the regions over the available threads. Once computed,
+ * only the regions with a station in the connected part of a station changed since are computed again.
+ */
+void region_flows(const FlowNetwork &net, RegionKind kind, RegionFlows &memo) {
+    unordered_map<uint32_t, vector<int>> members;
+    for (const auto &s : stations) members[region_of(s.second, kind)].push_back(s.first);
+
+    vector<int> part;
+    vector<bool> stale;                                 // connected parts with a changed station
+    unordered_map<uint32_t, double> kept;
+    if (memo.computed) {
+        part = net.parts();
+        stale.assign(net.getNumVertex(), false);
+        for (int id : memo.changed)
+            if (net.index(id) != -1) stale[part[net.index(id)]] = true;
+        for (const auto &f : memo.flows) kept.insert(f);
+    }
+    vector<pair<uint32_t, double>> flows;
+    vector<pair<size_t, const vector<int> *>> regions;  // regions computed again, by position in flows
+    for (const auto &m : members) {
+        bool again = !memo.computed || kept.find(m.first) == kept.end();
+        for (size_t i = 0; !again && i < m.second.size(); i++) {
+            int v = net.index(m.second[i]);
+            again = v != -1 && stale[part[v]];
+        }
+        if (again) regions.emplace_back(flows.size(), &m.second);
+        flows.emplace_back(m.first, again ? 0 : kept[m.first]);
+    }
+    parallel_for(regions.size(), (int) thread::hardware_concurrency(), [&](size_t i, FlowScratch &local) {
+        flows[regions[i].first].second = net.inflow(*regions[i].second, local);
+    });
+    memo.flows = move(flows);
+    memo.computed = true;
+    memo.changed.clear();
+}
+
+/*
+ * Arrivals at every station of the copy of the network for a mask of services, and the stations changed since then
+ * whose connected parts have to be computed again.
+ */
+struct Arrivals {
+    shared_ptr<const ArrivalsIndex> index;
+    vector<int> changed;
+};
+
+mutex arrivalsLock;
+unordered_map<unsigned int, Arrivals> arrivals;         // by mask of services
+
+/*
+ * Arrivals at every station of the current copy of the network for a mask of services, computed on the first call for
+ * each mask, and then again only for the connected parts the graph changed in.
+ */
+shared_ptr<const ArrivalsIndex> current_arrivals(const shared_ptr<const FlowNetwork> &net, unsigned int services) {
+    lock_guard<mutex> guard(arrivalsLock);
+    auto &memo = arrivals[services];
+    if (memo.index == nullptr) memo.index = make_shared<const ArrivalsIndex>(net);
+    else if (&memo.index->getNetwork() != net.get()) memo.index = make_shared<const ArrivalsIndex>(net, *memo.index, memo.changed);
+    memo.changed.clear();
+    return memo.index;
+}
+
+/*
+ * Drops every cached result. Must be called with networkLock held.
+ */
+void forget_results() {
+    {
+        lock_guard<mutex> guard(cacheLock);
+        flowCache.resize(flowCache.getCapacity());
+        routeCache.resize(routeCache.getCapacity());
+    }
+    {
+        lock_guard<mutex> guard(arrivalsLock);
+        arrivals.clear();
+    }
+    lock_guard<mutex> guard(regionLock);
+    for (auto &kind : regionFlows) kind.clear();
+}
+
+/*
+ * Whether the loaded graph has a segment of some services between two stations.
+ */
+bool joined_by(int id1, int id2, unsigned int services) {
+    Vertex *v = g.findVertex(id1);
+    if (v == nullptr) return false;
+    for (Edge *e : v->getAdj())
+        if (e->getDest()->getId() == id2 && (e->getService() & services)) return true;
+    return false;
+}
+
+/*
+ * What a batch of updates did to the copy of the network for a mask of services, from before the updates.
+ */
+struct Damage {
+    shared_ptr<const BlockCutTree> tree;
+    unordered_set<int> blocks;                          // blocks with a segment added, removed or modified
+    bool joined = false;                                // whether a segment was added between two blocks
+    vector<int> changed;                                // stations at the ends of those segments, and new stations
+    vector<bool> stale;                                 // stations in the connected part of a changed one, by position
+};
+
+/*
+ * Whether a batch of updates can have changed a cached result, from the stations it depends on: the arrivals at a
+ * station depend only on its connected part, and the flows and routes between two stations only on the blocks
+ * between them (every simple path between them stays in those blocks).
+ */
+bool damaged(const unordered_map<unsigned int, Damage> &damages, const QueryKey &key) {
+    auto it = damages.find(key.services);
+    if (it == damages.end()) return true;
+    const Damage &damage = it->second;
+    if (damage.changed.empty()) return false;
+    const FlowNetwork &net = damage.tree->getNetwork();
+    if (key.type == ARRIVALS) return net.index(key.source) == -1 || damage.stale[net.index(key.source)];
+    if (damage.joined) return true;
+    vector<BlockCutTree::Hop> hops;
+    if (!damage.tree->route(key.source, key.target, hops)) return net.index(key.source) == -1 || net.index(key.target) == -1;
+    for (const auto &hop : hops)
+        if (damage.blocks.count(hop.block)) return true;
+    return false;
+}
+
+} // namespace
+
+double maxFlow(int source, int target, unsigned int services) {
+    auto tree = current_blocks(services);
+    QueryKey key = {MAX_FLOW, source, target, services};
+    double flow;
+    if (cached(flowCache, key, flow)) return flow;
+
+    // the flow is held back by the weakest block, or station between blocks, on the way
+    flow = 0;
+    vector<BlockCutTree::Hop> hops;
+    if (tree->route(source, target, hops)) {
+        flow = INF;
+        for (size_t i = 0; i < hops.size() && flow > 0; i++) {
+            if (i > 0) flow = min(flow, tree->getNetwork().limitOf(hops[i].from));
+            flow = min(flow, block_flow(*tree, hops[i], services));
+        }
+    }
+    remember(flowCache, key, flow);
+    return flow;
+}
+
+double superSource(int station, unsigned int services) {
+    auto contraction = current_contraction(services);
+    QueryKey key = {ARRIVALS, station, station, services};
+    double flow;
+    if (cached(flowCache, key, flow)) return flow;
+    flow = contraction->core({station}).network.arrivals(station, coreScratch);
+    remember(flowCache, key, flow);
+    return flow;
+}
+
+Route cheapestRoute(int source, int target, unsigned int services) {
+    auto net = current_network(services);
+    QueryKey key = {CHEAPEST, source, target, services};
+    Route route;
+    if (cached(routeCache, key, route)) return route;
+    net->cheapest(source, target, scratch, route.stations, route.trains, route.cost);
+    remember(routeCache, key, route);
+    return route;
+}
+
+vector<vector<int>> trainRoutes(int source, int target, vector<double>& trains, unsigned int services) {
+    auto contraction = current_contraction(services);
+    auto core = contraction->core({source, target});
+    core.network.maxFlow(source, target, coreScratch);
+    contraction->expand(core, coreScratch, scratch);
+
+    vector<vector<int>> paths;
+    vector<double> amounts;
+    contraction->getNetwork().decompose(source, target, scratch, paths, amounts);
+    vector<size_t> order(paths.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return amounts[a] > amounts[b]; });
+
+    vector<vector<int>> routes;
+    trains.clear();
+    for (size_t i : order) {
+        routes.push_back(move(paths[i]));
+        trains.push_back(amounts[i]);
+    }
+    return routes;
+}
+
+double widestRoute(int source, int target, vector<int>& stations, unsigned int services) {
+    auto tree = current_widest(services);
+    stations = tree->path(source, target);
+    return stations.empty() ? 0 : tree->bottleneck(source, target);
+}
+
+double maxFlowWithout(const vector<pair<int, int>>& segments, int source, int target, unsigned int services) {
+    auto net = current_network(services);
+    for (const auto &s : segments) scratch.close(*net, s.first, s.second);
+    double flow = net->maxFlow(source, target, scratch);
+    scratch.open();
+    return flow;
+}
+
+vector<SegmentUpgrade> upgradeGains(int source, int target, double extra, int checks, double& flow, unsigned int services) {
+    auto net = current_network(services);
+    CapacitySensitivity sensitivity(*net, source, target);
+    flow = sensitivity.getFlow();
+    vector<SegmentUpgrade> upgrades;
+    for (const auto &u : sensitivity.upgrades(extra, checks)) upgrades.push_back({u.from, u.to, u.gain, u.verified});
+    return upgrades;
+}
+
+vector<PartCut> weakestCuts(bool randomized, uint64_t seed, unsigned int services) {
+    auto net = current_network(services);
+    vector<PartCut> cuts;
+    for (const auto &part : GlobalMinCut(*net).parts()) {
+        auto cut = randomized ? part.kargerStein(seed, GlobalMinCut::highProbabilityRuns(part.getNumVertex())) : part.stoerWagner();
+        cuts.push_back({cut.part, cut.value, cut.segments});
+    }
+    return cuts;
+}
+
+bool hasSegment(int id1, int id2) {
+    return current_network(ALL_SERVICES)->adjacent(id1, id2);
+}
+
+CacheStats cacheStats() {
+    lock_guard<mutex> guard(cacheLock);
+    CacheStats stats;
+    stats.hits = flowCache.getHits() + routeCache.getHits();
+    stats.misses = flowCache.getMisses() + routeCache.getMisses();
+    stats.entries = flowCache.size() + routeCache.size();
+    stats.capacity = flowCache.getCapacity() + routeCache.getCapacity();
+    return stats;
+}
+
+void setCacheCapacity(size_t entries) {
+    lock_guard<mutex> guard(cacheLock);
+    flowCache.resize(entries);
+    routeCache.resize(entries);
+}
+
+void forgetChanges(const DeltaEffect& effect) {
+    lock_guard<mutex> guard(networkLock);
+    // results older than the updates are dropped by the next query anyway
+    if (effect.before == effect.after || resultsVersion != effect.before || networkVersion != effect.before) return;
+
+    // the copies of each mask still show the graph before the updates
+    unordered_map<unsigned int, Damage> damages;
+    for (const auto &copies : networks) {
+        unsigned int services = copies.first;
+        Damage &damage = damages[services];
+        damage.tree = copies.second.blocks;
+        const BlockCutTree &tree = *damage.tree;
+        const FlowNetwork &net = tree.getNetwork();
+        for (const auto &s : effect.segments) {
+            bool was = net.adjacent(s.first, s.second);
+            if (!was && !joined_by(s.first, s.second, services) && !joined_by(s.second, s.first, services)) continue;
+            int block = was ? tree.blockOf(s.first, s.second) : tree.sharedBlock(s.first, s.second);
+            if (block == -1) damage.joined = true;
+            else damage.blocks.insert(block);
+            damage.changed.push_back(s.first);
+            damage.changed.push_back(s.second);
+        }
+        for (int id : effect.stations)
+            if (net.index(id) == -1) damage.changed.push_back(id);
+        if (damage.changed.empty()) continue;
+
+        vector<int> part = net.parts();
+        vector<bool> stale(net.getNumVertex(), false);
+        for (int id : damage.changed)
+            if (net.index(id) != -1) stale[part[net.index(id)]] = true;
+        damage.stale.resize(part.size());
+        for (size_t v = 0; v < part.size(); v++) damage.stale[v] = stale[part[v]];
+    }
+
+    {
+        lock_guard<mutex> cacheGuard(cacheLock);
+        flowCache.eraseIf([&](const QueryKey &key, double) { return damaged(damages, key); });
+        routeCache.eraseIf([&](const QueryKey &key, const Route &) { return damaged(damages, key); });
+    }
+    {
+        lock_guard<mutex> arrivalsGuard(arrivalsLock);
+        for (auto it = arrivals.begin(); it != arrivals.end();) {
+            auto damage = damages.find(it->first);
+            if (damage == damages.end()) it = arrivals.erase(it);
+            else {
+                it->second.changed.insert(it->second.changed.end(), damage->second.changed.begin(), damage->second.changed.end());
+                ++it;
+            }
+        }
+    }
+    {
+        lock_guard<mutex> regionGuard(regionLock);
+        for (auto &kind : regionFlows)
+            for (auto it = kind.begin(); it != kind.end();) {
+                auto damage = damages.find(it->first);
+                if (damage == damages.end()) it = kind.erase(it);
+                else {
+                    it->second.changed.insert(it->second.changed.end(), damage->second.changed.begin(), damage->second.changed.end());
+                    ++it;
+                }
+            }
+    }
+
+    // the copies are built again for the graph after the updates, so the next batch of updates can be told apart too
+    resultsVersion = effect.after;
+    for (const auto &d : damages) refresh_network(d.first);
+}
+
+vector<uint32_t> topRegions(const unordered_map<uint32_t, int>& totals, int k) {
+    vector<pair<int, uint32_t>> ranked;
+    ranked.reserve(totals.size());
+    for (const auto &t : totals) ranked.emplace_back(t.second, t.first);
+
+    auto first = [](const pair<int, uint32_t> &a, const pair<int, uint32_t> &b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    vector<uint32_t> top;
+    for (const auto &r : topK(ranked, (size_t) max(k, 0), first)) top.push_back(r.second);
+    return top;
+}
+
+vector<pair<uint32_t, double>> topRegionsByFlow(RegionKind kind, int k, unsigned int services) {
+    auto net = current_network(services);
+
+    auto first = [](const pair<uint32_t, double> &a, const pair<uint32_t, double> &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+
+    lock_guard<mutex> guard(regionLock);
+    auto &memo = regionFlows[(int) kind][services];
+    if (!memo.computed || !memo.changed.empty()) region_flows(*net, kind, memo);
+    return topK(memo.flows, (size_t) max(k, 0), first);
+}
+
+vector<pair<int, double>> failureImpact(const vector<pair<int, int>>& segments, int k, unsigned int services) {
+    auto net = current_network(services);
+    auto index = current_arrivals(net, services);
+
+    vector<pair<int, double>> changed;
+    for (const auto &s : segments) scratch.close(*net, s.first, s.second);
+    for (int id : index->affected(scratch)) changed.emplace_back(id, net->arrivals(id, scratch) - index->arrivals(id));
+    scratch.open();
+    return largestChanges(changed, k);
+}
+
+vector<pair<int, double>> largestChanges(vector<pair<int, double>> changes, int k) {
+    changes.erase(remove_if(changes.begin(), changes.end(), [](const pair<int, double> &c) { return c.second == 0; }), changes.end());
+    auto first = [](const pair<int, double> &a, const pair<int, double> &b) {
+        return fabs(a.second) != fabs(b.second) ? fabs(a.second) > fabs(b.second) : a.first < b.first;
+    };
+    return topK(changes, (size_t) max(k, 0), first);
+}
+
+vector<Contingency> contingencySweep(const vector<pair<int, int>>& pairs, int threads, unsigned int services) {
+    auto net = current_network(services);
+    auto tree = current_blocks(services);
+    auto index = current_arrivals(net, services);
+
+    auto segments = all_segments(*net);
+    auto crossed = crossed_blocks(*tree, pairs);
+    vector<double> before(pairs.size());
+    for (size_t p = 0; p < pairs.size(); p++) before[p] = maxFlow(pairs[p].first, pairs[p].second, services);
+
+    vector<Contingency> sweep(segments.size());
+    parallel_for(segments.size(), threads, [&](size_t i, FlowScratch &local) {
+        Contingency &c = sweep[i];
+        c.station1 = segments[i].first;
+        c.station2 = segments[i].second;
+        int block = tree->blockOf(c.station1, c.station2);
+        local.close(*net, c.station1, c.station2);
+
+        for (int id : index->affected(local)) {
+            double loss = index->arrivals(id) - net->arrivals(id, local);
+            if (loss == 0) continue;
+            c.affected++;
+            c.lost += loss;
+            if (loss > c.worstLoss) {
+                c.worst = id;
+                c.worstLoss = loss;
+            }
+        }
+        c.pairLosses.assign(pairs.size(), 0);
+        for (size_t p = 0; p < pairs.size(); p++) {
+            if (find(crossed[p].begin(), crossed[p].end(), block) == crossed[p].end()) continue;
+            c.pairLosses[p] = before[p] - net->maxFlow(pairs[p].first, pairs[p].second, local);
+            c.pairsLost += c.pairLosses[p];
+        }
+        local.open();
+    });
+
+    sort(sweep.begin(), sweep.end(), [](const Contingency &a, const Contingency &b) {
+        if (a.pairsLost != b.pairsLost) return a.pairsLost > b.pairsLost;
+        if (a.lost != b.lost) return a.lost > b.lost;
+        return make_pair(a.station1, a.station2) < make_pair(b.station1, b.station2);
+    });
+    return sweep;
+}
+
+ReliabilityReport simulateFailures(const vector<pair<int, int>>& pairs, const ReliabilityOptions& options,
+                                   unsigned int services) {
+    auto net = current_network(services);
+    auto tree = current_blocks(services);
+
+    auto segments = all_segments(*net);
+    vector<int> segmentBlock(segments.size());
+    for (size_t j = 0; j < segments.size(); j++) segmentBlock[j] = tree->blockOf(segments[j].first, segments[j].second);
+    auto crossed = crossed_blocks(*tree, pairs);
+
+    ReliabilityReport report;
+    report.pairs.resize(pairs.size());
+    for (size_t p = 0; p < pairs.size(); p++) {
+        report.pairs[p].source = pairs[p].first;
+        report.pairs[p].target = pairs[p].second;
+        report.pairs[p].baseline = maxFlow(pairs[p].first, pairs[p].second, services);
+    }
+
+    vector<vector<double>> samples(pairs.size());     // flow of each pair in each scenario
+    int batch = max(1, options.batch);
+    while (report.scenarios < options.maxScenarios && !report.converged) {
+        int first = report.scenarios;
+        int count = min(batch, options.maxScenarios - first);
+        for (auto &s : samples) s.resize((size_t) (first + count));
+
+        vector<vector<int>> failed((size_t) count);
+        parallel_for((size_t) count, options.threads, [&](size_t i, FlowScratch &) {
+            for (size_t j = 0; j < segments.size(); j++)
+                if (counter_uniform(options.seed, (uint64_t) first + i, j) < options.failure) failed[i].push_back((int) j);
+        });
+        // a pair cut apart needs no max flow, the scenarios are split in a slice for each thread to find which
+        size_t slices = (size_t) max(1, options.threads), slice = ((size_t) count + slices - 1) / slices;
+        vector<unique_ptr<FailureConnectivity>> connectivity(slices);
+        parallel_for(slices, options.threads, [&](size_t k, FlowScratch &) {
+            size_t from = min((size_t) count, k * slice), to = min((size_t) count, from + slice);
+            vector<vector<int>> some(failed.begin() + (long) from, failed.begin() + (long) to);
+            connectivity[k] = make_unique<FailureConnectivity>(*net, segments, some);
+        });
+
+        parallel_for((size_t) count, options.threads, [&](size_t i, FlowScratch &local) {
+            vector<int> failedBlocks;
+            for (int j : failed[i]) failedBlocks.push_back(segmentBlock[j]);
+            bool closed = false;
+            for (size_t p = 0; p < pairs.size(); p++) {
+                double &flow = samples[p][first + i];
+                bool hit = false;
+                for (int b : crossed[p]) hit = hit || find(failedBlocks.begin(), failedBlocks.end(), b) != failedBlocks.end();
+                if (!hit) {
+                    flow = report.pairs[p].baseline;
+                    continue;
+                }
+                if (!connectivity[i / slice]->connected(i % slice, net->index(pairs[p].first), net->index(pairs[p].second))) {
+                    flow = 0;
+                    continue;
+                }
+                if (!closed) {
+                    for (int j : failed[i]) local.close(*net, segments[j].first, segments[j].second);
+                    closed = true;
+                }
+                flow = net->maxFlow(pairs[p].first, pairs[p].second, local);
+            }
+            local.open();
+        });
+        report.scenarios += count;
+
+        // 95% confidence interval of each mean, in scenario order so the sums do not depend on the threads
+        double widest = 0;
+        for (size_t p = 0; p < pairs.size(); p++) {
+            auto &r = report.pairs[p];
+            double sum = 0, squares = 0;
+            for (double x : samples[p]) sum += x;
+            r.mean = sum / report.scenarios;
+            for (double x : samples[p]) squares += (x - r.mean) * (x - r.mean);
+            r.deviation = report.scenarios > 1 ? sqrt(squares / (report.scenarios - 1)) : 0;
+            r.margin = 1.96 * r.deviation / sqrt((double) report.scenarios);
+            widest = max(widest, r.margin);
+        }
+        report.trace.emplace_back(report.scenarios, widest);
+        report.converged = report.scenarios > 1 && widest <= options.precision;
+    }
+
+    for (size_t p = 0; p < pairs.size(); p++) {
+        auto &r = report.pairs[p];
+        vector<double> &sorted = samples[p];
+        if (sorted.empty()) continue;
+        sort(sorted.begin(), sorted.end());
+        r.p5 = percentile(sorted, 0.05);
+        r.p50 = percentile(sorted, 0.5);
+        r.p95 = percentile(sorted, 0.95);
+        r.noFlow = (double) (upper_bound(sorted.begin(), sorted.end(), 0.0) - sorted.begin()) / (double) sorted.size();
+    }
+    return report;
+}
+
+vector<vector<vector<int>>> disconnectedStations(const vector<vector<pair<int, int>>>& scenarios) {
+    auto net = current_network(ALL_SERVICES);
+    auto segments = all_segments(*net);
+
+    vector<vector<int>> failed(scenarios.size());
+    for (size_t i = 0; i < scenarios.size(); i++) {
+        for (const auto &s : scenarios[i]) {
+            auto segment = make_pair(min(s.first, s.second), max(s.first, s.second));
+            auto it = lower_bound(segments.begin(), segments.end(), segment);
+            if (it != segments.end() && *it == segment) failed[i].push_back((int) (it - segments.begin()));
+        }
+    }
+    FailureConnectivity connectivity(*net, segments, failed);
+    vector<vector<vector<int>>> islands(scenarios.size());
+    for (size_t i = 0; i < scenarios.size(); i++) islands[i] = connectivity.islands(i);
+    return islands;
+}
@@ -0,0 +1,242 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../headers/Server.h"
+#include "../headers/Batch.h"
+
+QueryPool::QueryPool(const ServerOptions& options): capacity((size_t) max(1, options.queue)) {
+    for (int i = 0; i < max(1, options.threads); i++) workers.emplace_back(&QueryPool::work, this);
+}
+
+QueryPool::~QueryPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    notEmpty.notify_all();
+    for (auto &worker : workers) worker.join();
+}
+
+future<string> QueryPool::submit(string line) {
+    Task task;
+    task.line = move(line);
+    future<string> answer = task.answer.get_future();
+
+    unique_lock<mutex> guard(lock);
+    notFull.wait(guard, [this] { return tasks.size() < capacity; });
+    tasks.push_back(move(task));
+    guard.unlock();
+    notEmpty.notify_one();
+    return answer;
+}
+
+size_t QueryPool::queueCapacity() const {
+    return capacity;
+}
+
+void QueryPool::work() {
+    string response;
+    while (true) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this] { return stopping || !tasks.empty(); });
+        if (tasks.empty()) return;
+        Task task = move(tasks.front());
+        tasks.pop_front();
+        guard.unlock();
+        notFull.notify_one();
+
+        string error = answer_query(task.line, response);
+        task.answer.set_value(error.empty() ? response : "error," + error);
+    }
+}
+
+namespace {
+
+/*
+ * Answers of one client in the order of its queries. The reader waits while it is full, so a client that stops
+ * reading its answers also stops the server from reading its queries.
+ */
+class Pending {
+public:
+    explicit Pending(size_t capacity): capacity(capacity) {}
+
+    void push(future<string> answer) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [this] { return answers.size() < capacity; });
+        answers.push_back(move(answer));
+        notEmpty.notify_one();
+    }
+
+    void close() {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_one();
+    }
+
+    /*
+     * Waits for the next answer. Returns false once the reader closed and every answer was taken,
+     * last is set when no other answer is queued, the moment to flush.
+     */
+    bool pop(string &answer, bool &last) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [this] { return closed || !answers.empty(); });
+        if (answers.empty()) return false;
+        future<string> next = move(answers.front());
+        answers.pop_front();
+        last = answers.empty();
+        guard.unlock();
+        notFull.notify_one();
+        answer = next.get();
+        return true;
+    }
+
+private:
+    size_t capacity;
+    deque<future<string>> answers;
+    mutex lock;
+    condition_variable notEmpty, notFull;
+    bool closed = false;
+};
+
+/*
+ * Serves one client: the calling thread reads the queries and a second thread writes the answers.
+ */
+void serve(const function<bool(string &)> &read, const function<bool(const string &, bool)> &write, QueryPool &pool, size_t capacity) {
+    Pending pending(capacity);
+    thread writer([&] {
+        string answer;
+        bool last;
+        bool open = true;
+        while (pending.pop(answer, last)) {
+            if (open) open = write(answer, last);
+        }
+    });
+
+    string line;
+    while (read(line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        pending.push(pool.submit(line));
+    }
+    pending.close();
+    writer.join();
+}
+
+/*
+ * Reads lines from a socket.
+ */
+class SocketReader {
+public:
+    explicit SocketReader(int fd): fd(fd) {}
+
+    bool operator()(string &line) {
+        while (true) {
+            size_t end = buffer.find('\n', start);
+            if (end != string::npos) {
+                line.assign(buffer, start, end - start);
+                start = end + 1;
+                return true;
+            }
+            buffer.erase(0, start);
+            start = 0;
+
+            char chunk[4096];
+            ssize_t n = ::read(fd, chunk, sizeof chunk);
+            if (n <= 0) {
+                if (buffer.empty()) return false;
+                line.swap(buffer);
+                buffer.clear();
+                return true;
+            }
+            buffer.append(chunk, (size_t) n);
+        }
+    }
+
+private:
+    int fd;
+    string buffer;
+    size_t start = 0;
+};
+
+bool send_all(int fd, const string &data) {
+    for (size_t sent = 0; sent < data.size();) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += (size_t) n;
+    }
+    return true;
+}
+
+} // namespace
+
+void serve_stream(istream& in, ostream& out, QueryPool& pool) {
+    auto read = [&](string &line) { return (bool) getline(in, line); };
+    auto write = [&](const string &answer, bool last) {
+        out << answer << '\n';
+        if (last) out.flush();
+        return (bool) out;
+    };
+    serve(read, write, pool, pool.queueCapacity());
+}
+
+string serve_socket(const string& path, QueryPool& pool) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof address.sun_path) return "the path is too long for a socket";
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof address.sun_path - 1);
+
+    // only a socket left by an earlier server is replaced, never a file that happens to have the name
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) return path + " exists and is not a socket";
+        unlink(path.c_str());
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server == -1) return strerror(errno);
+    if (bind(server, (sockaddr *) &address, sizeof address) == -1 || listen(server, SOMAXCONN) == -1) {
+        string error = strerror(errno);
+        ::close(server);
+        return error;
+    }
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client == -1) {
+            int error = errno;
+            if (error == EINTR || error == ECONNABORTED) continue;
+            if (error != EMFILE && error != ENFILE && error != ENOBUFS && error != ENOMEM) {
+                ::close(server);
+                return strerror(error);
+            }
+            // out of descriptors or memory: wait for clients to finish instead of spinning
+            cerr << "accept: " << strerror(error) << ", retrying" << endl;
+            this_thread::sleep_for(chrono::milliseconds(100));
+            continue;
+        }
+        thread([client, &pool] {
+            SocketReader read(client);
+            string buffer;
+            auto write = [&](const string &answer, bool last) {
+                buffer += answer;
+                buffer += '\n';
+                if (!last && buffer.size() < (1 << 16)) return true;
+                bool sent = send_all(client, buffer);
+                buffer.clear();
+                return sent;
+            };
+            serve(read, write, pool, pool.queueCapacity());
+            ::close(client);
+        }).detach();
+    }
+}
@@ -0,0 +1,412 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "../headers/Snapshot.h"
+#include "../headers/Dataset.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_MMAP
+#endif
+
+namespace {
+
+/** Fixed-size header at the start of every snapshot, followed by the payload sections (each padded to 8 bytes):
+ * string offsets, string bytes, stations, vertex ids, vertex capacities, CSR offsets, arcs, connections, districts, municipalities */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t payloadSize;
+    uint64_t checksum;
+    uint64_t stationsSize;
+    int64_t stationsTime;
+    uint64_t networkSize;
+    int64_t networkTime;
+    uint32_t numStrings;
+    uint32_t stringBytes;
+    uint32_t numStations;
+    uint32_t numVertices;
+    uint32_t numArcs;
+    uint32_t numConnections;
+    uint32_t numDistricts;
+    uint32_t numMunicipalities;
+};
+
+struct SnapshotStation {
+    int32_t id;
+    uint32_t name, district, municipality, township, tline;
+};
+
+struct SnapshotArc {
+    uint32_t dest;      // index of the destination vertex
+    uint32_t reverse;   // index of the reverse arc, or NO_REVERSE
+    double weight;
+    int32_t price;
+    uint32_t service;   // service bit of the edge
+};
+
+struct SnapshotConnection {
+    int32_t id;
+    int32_t station1;
+    int32_t station2;
+    int32_t capacity;
+    uint32_t service;
+    uint32_t padding;
+};
+
+struct SnapshotAggregate {
+    uint32_t name;
+    int32_t total;
+};
+
+const char SNAPSHOT_MAGIC[8] = {'T', 'P', 'S', 'N', 'A', 'P', '\0', '\0'};
+const uint32_t NO_REVERSE = UINT32_MAX;
+
+size_t align8(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+/*
+ * FNV-1a over 64-bit words, the payload is always padded to a multiple of 8 bytes.
+ */
+uint64_t checksum(const unsigned char *data, size_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash ^= word;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool source_stamp(const string& file, uint64_t &size, int64_t &time) {
+    error_code ec;
+    size = filesystem::file_size(file, ec);
+    if (ec) return false;
+    auto t = filesystem::last_write_time(file, ec);
+    if (ec) return false;
+    time = (int64_t) t.time_since_epoch().count();
+    return true;
+}
+
+class PayloadWriter {
+public:
+    vector<unsigned char> bytes;
+
+    template <class T>
+    void section(const vector<T> &v) {
+        append(v.data(), v.size() * sizeof(T));
+    }
+
+    void append(const void *p, size_t n) {
+        if (n == 0) return;
+        size_t at = bytes.size();
+        bytes.resize(align8(at + n));
+        memcpy(bytes.data() + at, p, n);
+    }
+};
+
+class PayloadReader {
+public:
+    PayloadReader(const unsigned char *data, size_t size): data(data), size(size) {}
+
+    template <class T>
+    const T *section(size_t count) {
+        size_t n = count * sizeof(T);
+        if (n > size - at) return nullptr;
+        auto p = reinterpret_cast<const T *>(data + at);
+        at = std::min(size, align8(at + n));
+        return p;
+    }
+
+private:
+    const unsigned char *data;
+    size_t size;
+    size_t at = 0;
+};
+
+/*
+ * Read-only view of a whole file: mmap where available, a plain read everywhere else.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const string &file) {
+#ifdef SNAPSHOT_MMAP
+        int fd = open(file.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                map = p;
+                length = (size_t) st.st_size;
+            }
+        }
+        close(fd);
+#else
+        ifstream in(file, ios::binary);
+        if (!in) return;
+        buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef SNAPSHOT_MMAP
+        if (map != nullptr) munmap(map, length);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const unsigned char *data() const {
+#ifdef SNAPSHOT_MMAP
+        return static_cast<const unsigned char *>(map);
+#else
+        return buffer.data();
+#endif
+    }
+
+    size_t size() const {
+#ifdef SNAPSHOT_MMAP
+        return length;
+#else
+        return buffer.size();
+#endif
+    }
+
+private:
+#ifdef SNAPSHOT_MMAP
+    void *map = nullptr;
+    size_t length = 0;
+#else
+    vector<unsigned char> buffer;
+#endif
+};
+
+template <class K, class V>
+vector<K> sorted_keys(const unordered_map<K, V> &m) {
+    vector<K> keys;
+    keys.reserve(m.size());
+    for (const auto &p : m) keys.push_back(p.first);
+    sort(keys.begin(), keys.end());
+    return keys;
+}
+
+} // namespace
+
+string snapshot_path(const string& network_file) {
+    return network_file + ".snap";
+}
+
+bool write_snapshot(const string& file, const string& stations_file, const string& network_file) {
+    SnapshotHeader header{};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    if (!source_stamp(stations_file, header.stationsSize, header.stationsTime)) return false;
+    if (!source_stamp(network_file, header.networkSize, header.networkTime)) return false;
+
+    PayloadWriter payload;
+
+    // Interned strings, services included so every connection can refer to its service by id
+    StringPool &pool = Station::strings();
+    for (const auto &c : connections) pool.intern(c.second.second.second);
+    vector<uint32_t> offsets(pool.size() + 1, 0);
+    string blob;
+    for (uint32_t i = 0; i < pool.size(); i++) {
+        blob += pool.get(i);
+        offsets[i + 1] = (uint32_t) blob.size();
+    }
+    header.numStrings = (uint32_t) pool.size();
+    header.stringBytes = (uint32_t) blob.size();
+    payload.section(offsets);
+    payload.append(blob.data(), blob.size());
+
+    // Stations
+    vector<SnapshotStation> stationTable;
+    for (int id : sorted_keys(stations)) {
+        const Station &s = stations.at(id);
+        stationTable.push_back({id, s.getNameId(), s.getDistrictId(), s.getMunicipalityId(), s.getTownshipId(), s.getTlineId()});
+    }
+    header.numStations = (uint32_t) stationTable.size();
+    payload.section(stationTable);
+
+    // Graph in CSR form, arcs keep the order of each adjacency list
+    auto vertices = g.getVertexSet();
+    unordered_map<const Vertex *, uint32_t> vertexIdx;
+    unordered_map<const Edge *, uint32_t> arcIdx;
+    vector<int32_t> vertexIds;
+    vector<double> vertexCapacities;
+    vector<uint32_t> csr(vertices.size() + 1, 0);
+    uint32_t numArcs = 0;
+    for (uint32_t i = 0; i < vertices.size(); i++) {
+        vertexIdx[vertices[i]] = i;
+        vertexIds.push_back(vertices[i]->getId());
+        vertexCapacities.push_back(vertices[i]->getCapacity());
+        for (auto e : vertices[i]->getAdj()) arcIdx[e] = numArcs++;
+        csr[i + 1] = numArcs;
+    }
+    vector<SnapshotArc> arcs;
+    arcs.reserve(numArcs);
+    for (auto v : vertices) {
+        for (auto e : v->getAdj()) {
+            auto rev = e->getReverse() == nullptr ? arcIdx.end() : arcIdx.find(e->getReverse());
+            arcs.push_back({vertexIdx.at(e->getDest()), rev == arcIdx.end() ? NO_REVERSE : rev->second, e->getWeight(), e->getPrice(), e->getService()});
+        }
+    }
+    header.numVertices = (uint32_t) vertices.size();
+    header.numArcs = (uint32_t) arcs.size();
+    payload.section(vertexIds);
+    payload.section(vertexCapacities);
+    payload.section(csr);
+    payload.section(arcs);
+
+    // Connections
+    vector<SnapshotConnection> connectionTable;
+    for (int id : sorted_keys(connections)) {
+        const edge &c = connections.at(id);
+        connectionTable.push_back({id, c.first.first, c.first.second, c.second.first, pool.find(c.second.second), 0});
+    }
+    header.numConnections = (uint32_t) connectionTable.size();
+    payload.section(connectionTable);
+
+    // Aggregates
+    vector<SnapshotAggregate> districtTable, municipalityTable;
+    for (uint32_t id : sorted_keys(districts)) districtTable.push_back({id, districts.at(id)});
+    for (uint32_t id : sorted_keys(municipalities)) municipalityTable.push_back({id, municipalities.at(id)});
+    header.numDistricts = (uint32_t) districtTable.size();
+    header.numMunicipalities = (uint32_t) municipalityTable.size();
+    payload.section(districtTable);
+    payload.section(municipalityTable);
+
+    header.payloadSize = payload.bytes.size();
+    header.checksum = checksum(payload.bytes.data(), payload.bytes.size());
+
+    // Written next to the target and renamed, so a crash never leaves a half-written snapshot behind
+    string tmp = file + ".tmp";
+    {
+        ofstream out(tmp, ios::binary | ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(payload.bytes.data()), (streamsize) payload.bytes.size());
+        if (!out) return false;
+    }
+    error_code ec;
+    filesystem::rename(tmp, file, ec);
+    if (ec) {
+        filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+bool load_snapshot(const string& file, const string& stations_file, const string& network_file) {
+    MappedFile mapped(file);
+    if (mapped.data() == nullptr || mapped.size() < sizeof(SnapshotHeader)) return false;
+
+    SnapshotHeader header;
+    memcpy(&header, mapped.data(), sizeof(header));
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) return false;
+    if (header.version != SNAPSHOT_VERSION || header.headerSize != sizeof(SnapshotHeader)) return false;
+    if (header.payloadSize != mapped.size() - sizeof(SnapshotHeader)) return false;
+
+    // Stale if either csv changed since the snapshot was taken
+    uint64_t size;
+    int64_t time;
+    if (!source_stamp(stations_file, size, time) || size != header.stationsSize || time != header.stationsTime) return false;
+    if (!source_stamp(network_file, size, time) || size != header.networkSize || time != header.networkTime) return false;
+
+    const unsigned char *data = mapped.data() + sizeof(SnapshotHeader);
+    if (checksum(data, header.payloadSize) != header.checksum) return false;
+
+    PayloadReader reader(data, header.payloadSize);
+    auto offsets = reader.section<uint32_t>(header.numStrings + 1);
+    auto blob = reader.section<char>(header.stringBytes);
+    auto stationTable = reader.section<SnapshotStation>(header.numStations);
+    auto vertexIds = reader.section<int32_t>(header.numVertices);
+    auto vertexCapacities = reader.section<double>(header.numVertices);
+    auto csr = reader.section<uint32_t>(header.numVertices + 1);
+    auto arcs = reader.section<SnapshotArc>(header.numArcs);
+    auto connectionTable = reader.section<SnapshotConnection>(header.numConnections);
+    auto districtTable = reader.section<SnapshotAggregate>(header.numDistricts);
+    auto municipalityTable = reader.section<SnapshotAggregate>(header.numMunicipalities);
+    if (offsets == nullptr || blob == nullptr || stationTable == nullptr || vertexIds == nullptr || vertexCapacities == nullptr || csr == nullptr ||
+        arcs == nullptr || connectionTable == nullptr || districtTable == nullptr || municipalityTable == nullptr)
+        return false;
+
+    // Validate every index before touching the dataset, so a rejected snapshot leaves nothing half-loaded
+    if (offsets[header.numStrings] != header.stringBytes || csr[header.numVertices] != header.numArcs) return false;
+    for (uint32_t i = 0; i < header.numStrings; i++)
+        if (offsets[i] > offsets[i + 1]) return false;
+    for (uint32_t i = 0; i < header.numVertices; i++)
+        if (csr[i] > csr[i + 1]) return false;
+    for (uint32_t i = 0; i < header.numArcs; i++)
+        if (arcs[i].dest >= header.numVertices || (arcs[i].reverse != NO_REVERSE && arcs[i].reverse >= header.numArcs)) return false;
+    auto validString = [&](uint32_t id) { return id < header.numStrings; };
+    for (uint32_t i = 0; i < header.numStations; i++) {
+        const auto &s = stationTable[i];
+        if (!validString(s.name) || !validString(s.district) || !validString(s.municipality) || !validString(s.township) || !validString(s.tline)) return false;
+    }
+    for (uint32_t i = 0; i < header.numConnections; i++)
+        if (!validString(connectionTable[i].service)) return false;
+    for (uint32_t i = 0; i < header.numDistricts; i++)
+        if (!validString(districtTable[i].name)) return false;
+    for (uint32_t i = 0; i < header.numMunicipalities; i++)
+        if (!validString(municipalityTable[i].name)) return false;
+
+    // Snapshot string ids are remapped, in case the pool already holds strings
+    StringPool &pool = Station::strings();
+    vector<uint32_t> remap(header.numStrings);
+    for (uint32_t i = 0; i < header.numStrings; i++)
+        remap[i] = pool.intern(string_view(blob + offsets[i], offsets[i + 1] - offsets[i]));
+
+    stations.reserve(header.numStations);
+    stations_name.reserve(header.numStations);
+    for (uint32_t i = 0; i < header.numStations; i++) {
+        const auto &s = stationTable[i];
+        Station station(remap[s.name], remap[s.district], remap[s.municipality], remap[s.township], remap[s.tline]);
+        stations.insert({s.id, station});
+        stations_name.insert({station.getNameId(), s.id});
+    }
+
+    vector<Vertex *> vertices(header.numVertices);
+    for (uint32_t i = 0; i < header.numVertices; i++) {
+        g.addVertex(vertexIds[i]);
+        vertices[i] = g.findVertex(vertexIds[i]);
+        if (vertexCapacities[i] != INF) g.setVertexCapacity(vertexIds[i], vertexCapacities[i]);
+    }
+    vector<Edge *> edges(header.numArcs);
+    for (uint32_t v = 0; v < header.numVertices; v++)
+        for (uint32_t a = csr[v]; a < csr[v + 1]; a++) {
+            edges[a] = vertices[v]->addEdge(vertices[arcs[a].dest], arcs[a].weight, arcs[a].price);
+            edges[a]->setService(arcs[a].service);
+        }
+    for (uint32_t a = 0; a < header.numArcs; a++)
+        if (arcs[a].reverse != NO_REVERSE) edges[a]->setReverse(edges[arcs[a].reverse]);
+
+    connections.reserve(header.numConnections);
+    for (uint32_t i = 0; i < header.numConnections; i++) {
+        const auto &c = connectionTable[i];
+        edge temp = {{c.station1, c.station2}, {c.capacity, string(pool.get(remap[c.service]))}};
+        connections.insert({c.id, temp});
+    }
+
+    for (uint32_t i = 0; i < header.numDistricts; i++)
+        districts[remap[districtTable[i].name]] = districtTable[i].total;
+    for (uint32_t i = 0; i < header.numMunicipalities; i++)
+        municipalities[remap[municipalityTable[i].name]] = municipalityTable[i].total;
+
+    return true;
+}
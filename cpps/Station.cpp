@@ -4,53 +4,80 @@
 
 #include "../headers/Station.h"
 
+StringPool &Station::strings() {
+    static StringPool pool;
+    return pool;
+}
+
 Station::Station() = default;
 
-Station::Station(string name, string district, string municipality, string township, string tline){
-    this->name = name;
-    this->district = district;
-    this->municipality = municipality;
-    this->township = township;
-    this->tline = tline;
+Station::Station(string_view name, string_view district, string_view municipality, string_view township, string_view tline){
+    this->name = strings().intern(name);
+    this->district = strings().intern(district);
+    this->municipality = strings().intern(municipality);
+    this->township = strings().intern(township);
+    this->tline = strings().intern(tline);
+}
+
+Station::Station(uint32_t name, uint32_t district, uint32_t municipality, uint32_t township, uint32_t tline)
+    : name(name), district(district), municipality(municipality), township(township), tline(tline) {}
+
+string_view Station::getName() const {
+    return strings().get(name);
+}
+
+string_view Station::getDistrict() const {
+    return strings().get(district);
 }
 
-string Station::getName() const {
+string_view Station::getMunicipality() const {
+    return strings().get(municipality);
+}
+
+string_view Station::getTownship() const {
+    return strings().get(township);
+}
+
+string_view Station::getTline() const {
+    return strings().get(tline);
+}
+
+uint32_t Station::getNameId() const {
     return name;
 }
 
-string Station::getDistrict() const {
+uint32_t Station::getDistrictId() const {
     return district;
 }
 
-string Station::getMunicipality() const {
+uint32_t Station::getMunicipalityId() const {
     return municipality;
 }
 
-string Station::getTownship() const {
+uint32_t Station::getTownshipId() const {
     return township;
 }
 
-string Station::getTline() const {
+uint32_t Station::getTlineId() const {
     return tline;
 }
 
-void Station::setName(string name) {
-    Station::name = name;
+void Station::setName(string_view name) {
+    Station::name = strings().intern(name);
 }
 
-void Station::setDistrict(string district) {
-    Station::district = district;
+void Station::setDistrict(string_view district) {
+    Station::district = strings().intern(district);
 }
 
-void Station::setMunicipality(string municipality) {
-    Station::municipality = municipality;
+void Station::setMunicipality(string_view municipality) {
+    Station::municipality = strings().intern(municipality);
 }
 
-void Station::setTownship(string township) {
-    Station::township = township;
+void Station::setTownship(string_view township) {
+    Station::township = strings().intern(township);
 }
 
-void Station::setTline(string tline) {
-    Station::tline = tline;
+void Station::setTline(string_view tline) {
+    Station::tline = strings().intern(tline);
 }
-
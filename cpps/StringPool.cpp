@@ -0,0 +1,33 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#include "../headers/StringPool.h"
+
+uint32_t StringPool::intern(string_view s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) return it->second;
+
+    auto id = (uint32_t) strings.size();
+    strings.emplace_back(s);
+    ids.insert({strings.back(), id});
+    return id;
+}
+
+uint32_t StringPool::find(string_view s) const {
+    auto it = ids.find(s);
+    return it == ids.end() ? npos : it->second;
+}
+
+string_view StringPool::get(uint32_t id) const {
+    return strings[id];
+}
+
+size_t StringPool::size() const {
+    return strings.size();
+}
+
+void StringPool::clear() {
+    ids.clear();
+    strings.clear();
+}
@@ -0,0 +1,44 @@
+/*! \file */
+
+/**
+ * @brief Generator of synthetic rail networks, for testing the planner at scale
+ *
+ * Usage: generator --stations N [--seed S] [--alfa FRACTION] [--out DIRECTORY]
+ * Writes DIRECTORY/stations.csv and DIRECTORY/network.csv (the current directory by default).
+ */
+
+#include <iostream>
+#include <string>
+#include "headers/NetworkGenerator.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    GeneratorOptions options;
+    string out = ".";
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            return 1;
+        }
+        string value = argv[++i];
+        if (arg == "--stations") options.stations = stoi(value);
+        else if (arg == "--seed") options.seed = stoull(value);
+        else if (arg == "--alfa") options.alfaShare = stod(value);
+        else if (arg == "--out") out = value;
+        else {
+            cerr << "Unknown option " << arg << endl;
+            cerr << "Usage: generator --stations N [--seed S] [--alfa FRACTION] [--out DIRECTORY]" << endl;
+            return 1;
+        }
+    }
+
+    if (!generate_network(options, out + "/stations.csv", out + "/network.csv")) {
+        cerr << "Could not write the network to " << out << endl;
+        return 1;
+    }
+    cout << "Wrote " << options.stations << " stations to " << out << "/stations.csv and " << out << "/network.csv" << endl;
+    return 0;
+}
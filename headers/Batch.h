@@ -0,0 +1,103 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_BATCH_H
+#define DATP1_BATCH_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Queries.h"
+
+using namespace std;
+
+/** Summary of a batch of queries */
+struct BatchResult {
+
+    /** Number of queries answered */
+    int answered = 0;
+
+    /** One message per rejected query, prefixed by its line number */
+    vector<string> errors;
+};
+
+/** Function that answers a stream of queries on the loaded dataset, one per line, in the same comma separated style as the csv files:
+ *   maxflow,Station_A,Station_B[,Service]
+ *   arrivals,Station[,Service]
+ *   cheapest,Station_A,Station_B[,Service]
+ *   widest,Station_A,Station_B[,Service]
+ *   top,districts|municipalities,K
+ *   topflow,districts|municipalities|townships|lines,K[,Service]
+ *   impact,K[,Service],Station_A,Station_B[,Station_C,Station_D...]
+ *   islands,Station_A,Station_B[,Station_C,Station_D...]
+ *   routes,Station_A,Station_B[,Service]
+ *   upgrades,K,Extra,Station_A,Station_B[,Service]
+ *   mincut[,Seed][,Service]   (a seed runs the randomized cut)
+ *   cache
+ * A Service field keeps the query to the segments of STANDARD or ALFA PENDULAR, or of both joined by '+'. Empty lines and lines starting with '#' are ignored. Every answer is one line that repeats the query followed by its results:
+ *   maxflow,Station_A,Station_B[,Service],Flow
+ *   arrivals,Station[,Service],Flow
+ *   cheapest,Station_A,Station_B[,Service],Trains,Cost,Station_A;...;Station_B (or "unreachable")
+ *   widest,Station_A,Station_B[,Service],Trains,Station_A;...;Station_B (or "unreachable")
+ *   top,districts|municipalities,K,Name;Name;...
+ *   topflow,districts|municipalities|townships|lines,K[,Service],Name:Flow;Name:Flow;...
+ *   impact,K[,Service],Station_A,Station_B,...,Station:Change;Station:Change;...
+ *   islands,Station_A,Station_B,...,Station;Station;...|Station;...   (stations cut off, one group per island)
+ *   routes,Station_A,Station_B[,Service],Trains:Station_A;...;Station_B|Trains:...   (the max flow split into routes)
+ *   upgrades,K,Extra,Station_A,Station_B[,Service],Flow,Station to Station:Gain;...   (the K segments whose widening by Extra gains the most)
+ *   mincut[,Seed][,Service],Station:Stations:Capacity:Station_A to Station_B;...|...   (one cut per connected part, largest first,
+ *                  named by its station with the smallest id)
+ *   cache,Hits,Misses,Entries
+ * A rejected query is answered with error,Line,Message. The answers go through a buffer, not a flush per line
+ * @param in Stream with the queries
+ * @param out Stream where the answers are written
+ * @return How many queries were answered and rejected
+ * @brief Complexity O(q) queries, each with the complexity of its algorithm
+ */
+BatchResult run_batch(istream& in, ostream& out);
+
+/** Function that answers one query, in the format of run_batch. It only reads the dataset, so several threads
+ * can answer queries at the same time
+ * @param line Query, without the line break
+ * @param response Where the answer is written, without the line break
+ * @return Error message, empty if the query was answered
+ * @brief Complexity of the algorithm of the query
+ */
+string answer_query(const string& line, string& response);
+
+/** Function that answers the queries in a file, see run_batch
+ * @param queries_file String with the name of the file with the queries
+ * @param output_file String with the name of the file for the answers, standard output if empty
+ * @return How many queries were answered and rejected
+ * @brief Complexity O(q) queries, each with the complexity of its algorithm
+ */
+BatchResult run_batch_file(const string& queries_file, const string& output_file);
+
+/** Function that runs the N-1 contingency sweep (see contingencySweep) and writes its report, one line per segment, most critical first:
+ *   Rank,Station_A,Station_B,Stations_Affected,Arrivals_Lost,Worst_Station,Worst_Loss,Pairs_Lost[,Loss of each pair...]
+ * The header names each pair column Station_A to Station_B
+ * @param pairs_file String with the name of a file with the origin-destination pairs, Station_A,Station_B on each line, none if empty
+ * @param report_file String with the name of the file for the report, standard output if empty
+ * @param threads Number of threads
+ * @param services Mask of the services whose segments are swept and carry the flows
+ * @return How many segments were reported, and one message per rejected pair
+ * @brief Complexity of contingencySweep
+ */
+BatchResult run_sweep_file(const string& pairs_file, const string& report_file, int threads, unsigned int services = ALL_SERVICES);
+
+/** Function that simulates random segment failures (see simulateFailures) and writes the statistics of every pair:
+ *   Station_A,Station_B,Baseline,Mean,Deviation,Margin,P5,P50,P95,No_Flow
+ * followed by comment lines (starting with '#') with the number of scenarios and the widest margin after each batch
+ * @param pairs_file String with the name of a file with the origin-destination pairs, Station_A,Station_B on each line
+ * @param report_file String with the name of the file for the report, standard output if empty
+ * @param options Settings of the simulation
+ * @param services Mask of the services whose segments fail and carry the flows
+ * @return How many pairs were reported, and one message per rejected pair
+ * @brief Complexity of simulateFailures
+ */
+BatchResult run_reliability_file(const string& pairs_file, const string& report_file, const ReliabilityOptions& options,
+                                 unsigned int services = ALL_SERVICES);
+
+#endif //DATP1_BATCH_H
@@ -0,0 +1,92 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_DATASET_H
+#define DATP1_DATASET_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "Station.h"
+#include "../DataStructures/Graph.h"
+
+using namespace std;
+
+/** Graph of the loaded network, vertex ids are station ids */
+extern Graph g;
+
+/** Struct with the information of a connection: id1, id2, capacity, service */
+typedef pair<pair<int, int>, pair<int, string>> edge;
+
+/** Map with the stations, key = station id, value = Station */
+extern unordered_map<int, Station> stations;
+
+/** Map with the names of the stations, key = id of the station name in Station::strings(), value = station id */
+extern unordered_map<uint32_t, int> stations_name;
+
+/** Map with the connections, key = connection id, value = edge */
+extern unordered_map<int, edge> connections;
+
+/** Map with the districts, key = id of the district name in Station::strings(), value = number of stations */
+extern unordered_map<uint32_t, int> districts;
+
+/** Map with the municipalities, key = id of the municipality name in Station::strings(), value = number of stations */
+extern unordered_map<uint32_t, int> municipalities;
+
+/** Function that reads the stations from a file and stores them in the stations, stations_name, districts and municipalities maps.
+ * A station with a Capacity column after its Line gets that limit on the trains passing through it (see Graph::setVertexCapacity)
+ * @param file String with the name of the file
+ * @brief Complexity O(n), where n is the number of stations
+ */
+void read_stations(const string& file);
+
+/** Function that reads the connections from a file and stores them in the connections map, also adds the numbers of stations in each district and municipality to their respective maps.
+ * Large files are split at line boundaries and parsed on every core, connection ids still follow the order of the lines
+ * @param file String with the name of the file
+ * @brief Complexity O(n), where n is the number of connections
+ */
+void read_network(const string& file);
+
+/** Function that loads a dataset, from its binary snapshot when there is an up to date one, or else from the csv files (writing a new snapshot afterwards)
+ * @param stations_file String with the name of the stations file
+ * @param network_file String with the name of the network file
+ * @brief Complexity O(n + m), where n is the number of stations and m is the number of connections
+ */
+void load_dataset(const string& stations_file, const string& network_file);
+
+/** Function that empties the loaded dataset: the graph, every map and the interned strings
+ * @brief Complexity O(n + m), where n is the number of stations and m is the number of connections
+ */
+void clear_dataset();
+
+/** Function that returns the price per train of a service
+ * @param service String with the service of a connection
+ * @return 2 for STANDARD connections, 4 for any other
+ * @brief Complexity O(1)
+ */
+int service_price(string_view service);
+
+/** Function that returns the bit of a service in the service masks of the graph edges
+ * @param service String with the service of a connection
+ * @return 1 for STANDARD, 2 for ALFA PENDULAR, 4 for any other
+ * @brief Complexity O(1)
+ */
+unsigned int service_mask(string_view service);
+
+/** Function that reads a service filter, one or more services joined by '+', e.g. STANDARD+ALFA PENDULAR
+ * @param field String with the filter
+ * @param services Where the mask of the services is written
+ * @return True if every service in the filter is STANDARD or ALFA PENDULAR, false otherwise
+ * @brief Complexity O(n), where n is the length of the filter
+ */
+bool parse_services(string_view field, unsigned int &services);
+
+/** Function that finds the id of a station given its name
+ * @param name String with the name of the station
+ * @return Id of the station, or -1 if it does not exist
+ * @brief Complexity O(1)
+ */
+int findStation(string_view name);
+
+#endif //DATP1_DATASET_H
@@ -0,0 +1,61 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_DELTA_H
+#define DATP1_DELTA_H
+
+#include <istream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/** Summary of a batch of updates: what was touched, so that only results depending on it have to be recomputed */
+struct DeltaEffect {
+
+    /** Number of updates applied */
+    int applied = 0;
+
+    /** Ids of the stations whose segments (or themselves) changed */
+    unordered_set<int> stations;
+
+    /** Ids of the districts whose capacity total changed */
+    unordered_set<uint32_t> districts;
+
+    /** Ids of the municipalities whose capacity total changed */
+    unordered_set<uint32_t> municipalities;
+
+    /** Pairs of ids of the stations at the ends of every segment added, removed or modified */
+    vector<pair<int, int>> segments;
+
+    /** Versions of the graph before and after the updates (see Graph::getVersion) */
+    unsigned long before = 0, after = 0;
+
+    /** One message per rejected update, prefixed by its line number */
+    vector<string> errors;
+};
+
+/** Function that applies a stream of updates to the loaded dataset, one per line, in the same comma separated style as the csv files:
+ *   add_segment,Station_A,Station_B,Capacity,Service
+ *   remove_segment,Station_A,Station_B
+ *   modify_segment,Station_A,Station_B,Capacity[,Service]
+ *   add_station,Name,District,Municipality,Township,Line[,Capacity]
+ * Empty lines and lines starting with '#' are ignored. The graph, the connections map and the district and municipality
+ * totals are updated in place, invalid updates are skipped and reported
+ * @param in Stream with the updates
+ * @return What the updates changed
+ * @brief Complexity O(u*m), where u is the number of updates and m is the number of connections
+ */
+DeltaEffect apply_delta(istream& in);
+
+/** Function that applies the updates in a file, see apply_delta
+ * @param file String with the name of the file
+ * @return What the updates changed
+ * @brief Complexity O(u*m), where u is the number of updates and m is the number of connections
+ */
+DeltaEffect apply_delta_file(const string& file);
+
+#endif //DATP1_DELTA_H
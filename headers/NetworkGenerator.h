@@ -0,0 +1,38 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_NETWORKGENERATOR_H
+#define DATP1_NETWORKGENERATOR_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/** Parameters of a synthetic rail network */
+struct GeneratorOptions {
+
+    /** Total number of stations */
+    int stations = 1000;
+
+    /** Seed of the generator, the same seed and options always produce the same files */
+    uint64_t seed = 1;
+
+    /** Fraction of the trunk lines served by ALFA PENDULAR, the rest (and every branch) is STANDARD */
+    double alfaShare = 0.25;
+};
+
+/** Function that generates a synthetic rail network and writes it in the format of the stations and network csv files.
+ * Junction hubs are scattered over a map and linked to their nearest neighbours (with a few extra links closing loops),
+ * every link is a line of degree-2 intermediate stations and some hubs get dead-end branch lines. Districts,
+ * municipalities and townships are regions of the map, so neighbouring stations share them
+ * @param options Size, seed and service mix of the network
+ * @param stations_file String with the name of the stations file to write
+ * @param network_file String with the name of the network file to write
+ * @return True if both files were written, false otherwise
+ * @brief Complexity O(n), where n is the number of stations
+ */
+bool generate_network(const GeneratorOptions& options, const string& stations_file, const string& network_file);
+
+#endif //DATP1_NETWORKGENERATOR_H
@@ -0,0 +1,360 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_QUERIES_H
+#define DATP1_QUERIES_H
+
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Delta.h"
+#include "../DataStructures/VertexEdge.h"
+
+using namespace std;
+
+/** Cheapest route between two stations */
+struct Route {
+
+    /** Ids of the stations along the route, from the source to the target, empty if there is no route */
+    vector<int> stations;
+
+    /** Sum of the capacities of the segments along the route */
+    double trains = 0;
+
+    /** Cost of the route for the company */
+    double cost = 0;
+};
+
+/** Hit and miss counts of the result cache */
+struct CacheStats {
+
+    /** Queries answered from the cache */
+    unsigned long hits = 0;
+
+    /** Queries that had to be computed */
+    unsigned long misses = 0;
+
+    /** Results held */
+    size_t entries = 0;
+
+    /** Results the cache can hold */
+    size_t capacity = 0;
+};
+
+/** Outage of one segment, in the N-1 sweep */
+struct Contingency {
+
+    /** Ids of the stations at the ends of the segment */
+    int station1 = -1, station2 = -1;
+
+    /** Number of stations whose max arriving flow changed */
+    int affected = 0;
+
+    /** Max arriving flow lost by all stations together, gains count as negative losses */
+    double lost = 0;
+
+    /** Station that lost the most flow, -1 if none lost any */
+    int worst = -1;
+
+    /** Flow lost by the worst station */
+    double worstLoss = 0;
+
+    /** Max flow lost by each origin-destination pair, in the order they were given */
+    vector<double> pairLosses;
+
+    /** Max flow lost by all pairs together */
+    double pairsLost = 0;
+};
+
+/** Widening of one segment, in the capacity sensitivity study */
+struct SegmentUpgrade {
+
+    /** Ids of the stations at the ends of the segment, in the direction of the flow */
+    int station1 = -1, station2 = -1;
+
+    /** Max flow gained by widening the segment */
+    double gain = 0;
+
+    /** Whether the gain was checked with a max flow, otherwise it is a lower bound */
+    bool verified = false;
+};
+
+/** Weakest cut of one connected part of the network */
+struct PartCut {
+
+    /** Ids of the stations of the part, sorted */
+    vector<int> stations;
+
+    /** Capacity of the cut */
+    double capacity = 0;
+
+    /** Pairs of ids of the stations at the ends of each segment in the cut, the first on the smaller side */
+    vector<pair<int, int>> segments;
+};
+
+/** Settings of the simulation of random segment failures */
+struct ReliabilityOptions {
+
+    /** Probability that each segment fails in a scenario, independently of the others */
+    double failure = 0.01;
+
+    /** Seed of the failures: a seed always draws the same scenarios, whatever the number of threads */
+    uint64_t seed = 1;
+
+    /** Scenarios drawn between two checks of convergence */
+    int batch = 1000;
+
+    /** Most scenarios drawn */
+    int maxScenarios = 100000;
+
+    /** The simulation stops once the 95% confidence interval of every mean flow is at most this many trains on each side */
+    double precision = 0.05;
+
+    /** Number of threads */
+    int threads = (int) max(1u, thread::hardware_concurrency());
+};
+
+/** Max flow of an origin-destination pair over the simulated scenarios */
+struct PairReliability {
+
+    /** Ids of the origin and destination */
+    int source = -1, target = -1;
+
+    /** Max flow with every segment working */
+    double baseline = 0;
+
+    /** Mean and standard deviation of the max flow */
+    double mean = 0, deviation = 0;
+
+    /** Half width of the 95% confidence interval of the mean */
+    double margin = 0;
+
+    /** Max flow that 5%, 50% and 95% of the scenarios do not exceed */
+    double p5 = 0, p50 = 0, p95 = 0;
+
+    /** Fraction of the scenarios where no flow gets through */
+    double noFlow = 0;
+};
+
+/** Outcome of the simulation of random segment failures */
+struct ReliabilityReport {
+
+    /** Number of scenarios drawn */
+    int scenarios = 0;
+
+    /** Whether every margin reached the precision before the most scenarios were drawn */
+    bool converged = false;
+
+    /** One result per pair, in the order they were given */
+    vector<PairReliability> pairs;
+
+    /** Widest margin of the pairs after each batch, as (scenarios drawn, margin) */
+    vector<pair<int, double>> trace;
+};
+
+/*
+ * The queries run on a FlowNetwork copy of the loaded graph, rebuilt when the graph changes, and the results of the max-flow,
+ * arrivals and cheapest route queries are kept in a bounded LRU cache keyed by the query, its stations and its services.
+ * Updates the cache is told about (see forgetChanges) drop only the results they can have changed, any other change to the
+ * graph drops them all, so a result is never served after it changed. They can be called from several threads
+ * at once, as long as no thread changes the graph meanwhile. Given a mask of services (see service_mask), they only use
+ * the segments of those services: every mask asked for gets its own copy of the network with only those segments,
+ * with its own contracted lines, blocks and widest routes, built once per version of the graph.
+ */
+
+/** Function that returns the maximum number of trains that can simultaneously travel between two stations of the loaded network
+ * @param source Id of the first station
+ * @param target Id of the second station
+ * @param services Mask of the services whose segments the trains can use
+ * @return Double with the max flow between the stations: the smallest max flow across the blocks (biconnected components)
+ * between them, each computed on the block where the lines of stations with two neighbours are contracted and cached
+ * @brief Complexity O(k*c^2) for k junctions and terminals and c contracted lines of the largest block on the way
+ */
+double maxFlow(int source, int target, unsigned int services = ALL_SERVICES);
+
+/** Function that returns the max flow of a station as if the graph had one source and one sink:
+ * a super source feeds every terminal station (with a single segment) other than the station itself
+ * @param station Id of the station
+ * @param services Mask of the services whose segments the trains can use, a station left with one of them is a terminal
+ * @return Double with the max flow of the station, computed on the network where the lines of stations with two neighbours are contracted
+ * @brief Complexity O(k*c^2) for k junctions and terminals and c contracted lines
+ */
+double superSource(int station, unsigned int services = ALL_SERVICES);
+
+/** Function that finds the route between two stations with minimum cost for the company
+ * @param source Id of the first station
+ * @param target Id of the second station
+ * @param services Mask of the services whose segments the route can use
+ * @return Route found, with no stations if the target cannot be reached
+ * @brief Complexity O((|V|+|E|)*log(|V|))
+ */
+Route cheapestRoute(int source, int target, unsigned int services = ALL_SERVICES);
+
+/** Function that splits the max flow between two stations into the routes the trains take, with the trains on each
+ * @param source Id of the first station
+ * @param target Id of the second station
+ * @param trains Trains on each route
+ * @param services Mask of the services whose segments the routes can use
+ * @return Ids of the stations along each route, from the source to the target, most trains first
+ * @brief Complexity O(k*c^2) for the max flow on the contracted network, plus O(|E| + p*|V|) for p routes
+ */
+vector<vector<int>> trainRoutes(int source, int target, vector<double>& trains, unsigned int services = ALL_SERVICES);
+
+/** Function that finds the widest single route between two stations, the one whose narrowest segment carries the most trains.
+ * It runs on a maximum spanning forest of the network, by capacity, one for each mask of services, rebuilt with the other
+ * copies when the graph changes
+ * @param source Id of the first station
+ * @param target Id of the second station
+ * @param stations Ids of the stations along the route, from the source to the target, empty if there is no route
+ * @param services Mask of the services whose segments the route can use
+ * @return Double with the capacity of the narrowest segment of the route, 0 if there is no route
+ * @brief Complexity O(log(|V|) + l) for l stations on the route
+ */
+double widestRoute(int source, int target, vector<int>& stations, unsigned int services = ALL_SERVICES);
+
+/** Function that returns the max flow between two stations with some segments closed, which stay open in the loaded network
+ * @param segments Pairs of ids of the stations at the ends of each closed segment
+ * @param source Id of the first station
+ * @param target Id of the second station
+ * @param services Mask of the services whose segments the trains can use
+ * @return Double with the max flow between the stations
+ * @brief Complexity O(|V|*|E|^2)
+ */
+double maxFlowWithout(const vector<pair<int, int>>& segments, int source, int target, unsigned int services = ALL_SERVICES);
+
+/** Function that finds where the network is weakest overall, in each of its connected parts with two or more stations,
+ * since between the parts of a disconnected network the cut is 0: the segments of least total capacity whose closure
+ * splits the part in two, with Stoer-Wagner, or Karger-Stein when randomized, repeated log^2 times the size of the part
+ * so it is right with high probability
+ * @param randomized Whether to run Karger-Stein
+ * @param seed Seed of its random contractions
+ * @param services Mask of the services whose segments make up the network
+ * @return Cut of each part, largest part first (ties by smallest id)
+ * @brief Complexity O(|V|*|E|*log(|E|)), or O(|V|^2*log^4(|V|)) when randomized
+ */
+vector<PartCut> weakestCuts(bool randomized, uint64_t seed, unsigned int services = ALL_SERVICES);
+
+/** Function that checks if there is a segment between two stations
+ * @brief Complexity O(d) where d is the number of segments of the first station
+ */
+bool hasSegment(int id1, int id2);
+
+/** Function that returns the hit and miss counts of the result cache
+ * @brief Complexity O(1)
+ */
+CacheStats cacheStats();
+
+/** Function that empties the result cache and sets how many results of each kind (flows and routes) it holds, 0 disables it
+ * @brief Complexity O(n) where n is the number of cached results
+ */
+void setCacheCapacity(size_t entries);
+
+/** Function that drops the cached results a batch of updates can have changed, to be called right after apply_delta:
+ * the arrivals at the stations in a connected part of the network with a changed segment or new station, and the flows
+ * and routes between stations with such a segment in a block (biconnected component) between them, or every one of
+ * them if a segment joined two blocks. The arrivals at every station and the max flow into every region are computed
+ * again only for the connected parts with a change, the next time they are needed
+ * @param effect What the updates changed
+ * @brief Complexity O(m*(|V|+|E| + u*d + n*h)) for the m masks of services asked for, u updated segments, d the
+ * most segments of a station, n cached results and h the most blocks between two stations
+ */
+void forgetChanges(const DeltaEffect& effect);
+
+/** Function that ranks regions (districts or municipalities) by their total
+ * @param totals Map with the totals, key = id of the region name in Station::strings(), value = total
+ * @param k Number of regions to return
+ * @return Ids of the top k regions, highest total first (ties by name id)
+ * @brief Complexity O(n*log(k)) where n is the number of regions
+ */
+vector<uint32_t> topRegions(const unordered_map<uint32_t, int>& totals, int k);
+
+/** Kind of region the stations are grouped by */
+enum class RegionKind { District, Municipality, Township, Line };
+
+/** Function that ranks regions by their transportation needs: the max flow into the stations of the region, as if a
+ * super sink drained them, from every terminal station outside it, as if a super source fed them.
+ * The regions are computed in parallel, and the ranking of each kind is kept, computing again after updates only the
+ * regions in a connected part they changed (see forgetChanges)
+ * @param kind What the stations are grouped by
+ * @param k Number of regions to return
+ * @param services Mask of the services whose segments the trains can use, kept apart in the ranking of each kind
+ * @return Up to k pairs (id of the region name in Station::strings(), max flow), highest flow first (ties by name id)
+ * @brief Complexity O(r*|V|*|E|^2 / t) where r is the number of regions and t the number of threads
+ */
+vector<pair<uint32_t, double>> topRegionsByFlow(RegionKind kind, int k, unsigned int services = ALL_SERVICES);
+
+/** Function that finds the stations most affected by closing some segments: the max flow arriving at a station
+ * (see superSource) is computed again, without the segments, only if its flow uses one of them or a station left with
+ * a single segment lies beyond its minimum cut. The segments stay open in the loaded network
+ * @param segments Pairs of ids of the stations at the ends of each closed segment
+ * @param k Number of stations to return
+ * @param services Mask of the services whose segments the trains can use
+ * @return Up to k pairs (station id, change in its max flow) of the stations whose max flow changed, largest change first (ties by id)
+ * @brief Complexity O(a*|V|*|E|^2) for the a stations computed again, plus O(|V|^2*|E|^2) the first time for a mask of
+ * services and again for the connected parts changed by updates (see forgetChanges)
+ */
+vector<pair<int, double>> failureImpact(const vector<pair<int, int>>& segments, int k, unsigned int services = ALL_SERVICES);
+
+/** Function that keeps the largest changes of a list, by absolute value
+ * @param changes Pairs (station id, change), the ones with no change are dropped
+ * @param k Number of changes to keep
+ * @return Up to k changes, largest first (ties by id)
+ * @brief Complexity O(n*log(k)) where n is the number of changes
+ */
+vector<pair<int, double>> largestChanges(vector<pair<int, double>> changes, int k);
+
+/** Function that finds which segments are worth widening to raise the max flow between two stations, from a single max flow:
+ * only the full segments that cross a minimum cut can gain anything, and only the ones the widest residual paths through them
+ * cannot settle are checked, by resuming the max flow with the segment widened (see CapacitySensitivity)
+ * @param source Id of the first station
+ * @param target Id of the second station
+ * @param extra Trains added to the capacity of a segment
+ * @param checks Most segments checked with a max flow
+ * @param flow Max flow between the stations as they are
+ * @param services Mask of the services whose segments the trains can use
+ * @return Segments whose widening raises the max flow, largest gain first
+ * @brief Complexity O(|V|*|E|^2 + k*|V|*|E|*p) for k segments checked with p augmenting paths each
+ */
+vector<SegmentUpgrade> upgradeGains(int source, int target, double extra, int checks, double& flow,
+                                    unsigned int services = ALL_SERVICES);
+
+/** Function that closes every segment of the loaded network in turn, the N-1 contingency study, and measures the flow
+ * lost at every station (see failureImpact, only the stations that can change are computed again) and between
+ * origin-destination pairs (computed again only when the segment lies in a block they cross, see maxFlow).
+ * The segments are spread over worker threads, each with its own working memory
+ * @param pairs Ids of the origin and destination of each pair, may be empty
+ * @param threads Number of threads
+ * @param services Mask of the services whose segments the trains can use, only their segments are closed
+ * @return One outage per segment (parallel connections are one segment), most critical first: by flow lost by the pairs,
+ * then by flow lost by the stations, then by ids
+ * @brief Complexity O(s*(a+p)*|V|*|E|^2) for s segments, a stations computed again and p pairs, over the threads
+ */
+vector<Contingency> contingencySweep(const vector<pair<int, int>>& pairs, int threads, unsigned int services = ALL_SERVICES);
+
+/** Function that simulates random segment failures (Monte Carlo): in every scenario each segment of the loaded network fails
+ * with the given probability, drawn from a counter based generator on (seed, scenario, segment), and the max flow of every
+ * origin-destination pair is computed with the failed segments closed in the working memory of the thread, the network is
+ * never copied. A pair whose blocks (see maxFlow) all kept their segments keeps its baseline flow. Scenarios are drawn
+ * in batches, spread over the threads, until every confidence interval is narrow enough
+ * @param pairs Ids of the origin and destination of each pair
+ * @param options Probability of failure, seed, batches, precision and threads
+ * @param services Mask of the services whose segments the trains can use, only their segments fail
+ * @return Statistics of every pair and the convergence of the simulation
+ * @brief Complexity O(n*(s+f*p*|V|*|E|^2)) for n scenarios, s segments and p pairs, f the fraction of scenarios where a pair loses a block, over the threads
+ */
+ReliabilityReport simulateFailures(const vector<pair<int, int>>& pairs, const ReliabilityOptions& options,
+                                   unsigned int services = ALL_SERVICES);
+
+/** Function that finds, for many failure scenarios at once, which stations each one cuts off from which: the segments
+ * that fail in no scenario are joined once in a union-find, and the others are joined over the runs of scenarios where
+ * they are up and undone after them (see FailureConnectivity)
+ * @param scenarios Segments that fail in each scenario, as pairs of ids of the stations at their ends, unknown segments are ignored
+ * @return For each scenario, the groups of stations cut off from the largest part of what they were connected to
+ * (of parts as large, the one with the smallest id), largest group first, stations by id
+ * @brief Complexity O(c*|V|*log(|V|) + |E| + f*log(c)*log(|V|)) for c scenarios and f failed segments over all of them
+ */
+vector<vector<vector<int>>> disconnectedStations(const vector<vector<pair<int, int>>>& scenarios);
+
+#endif //DATP1_QUERIES_H
@@ -0,0 +1,91 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_SERVER_H
+#define DATP1_SERVER_H
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/** Options of the query server */
+struct ServerOptions {
+
+    /** Number of threads answering queries */
+    int threads = (int) max(1u, thread::hardware_concurrency());
+
+    /** Number of queries waiting for a thread (and of answers waiting to be sent, per client) before the readers stop reading */
+    int queue = 64;
+};
+
+/** Fixed set of threads that answer queries on the loaded dataset, which must not change while the pool exists */
+class QueryPool {
+public:
+    /** Constructor that starts the threads
+     * @param options Number of threads and size of the queue
+     * @brief Complexity O(t) where t is the number of threads
+     */
+    explicit QueryPool(const ServerOptions& options);
+
+    /** Destructor that answers the queries still queued and stops the threads
+     * @brief Complexity O(t) where t is the number of threads
+     */
+    ~QueryPool();
+
+    /** Function that queues a query, waiting while the queue is full
+     * @param line Query, in the format of run_batch
+     * @return Answer, a line without the line break: the answer of run_batch or error,Message
+     * @brief Complexity O(1), plus the wait for room in the queue
+     */
+    future<string> submit(string line);
+
+    /** Function that returns how many queries the queue holds
+     * @brief Complexity O(1)
+     */
+    size_t queueCapacity() const;
+
+private:
+    struct Task {
+        string line;
+        promise<string> answer;
+    };
+
+    void work();
+
+    size_t capacity;
+    deque<Task> tasks;
+    mutex lock;
+    condition_variable notEmpty, notFull;
+    bool stopping = false;
+    vector<thread> workers;
+};
+
+/** Function that serves the queries of one client reading from a stream and answering to another, e.g. a pipe pair.
+ * Each line is a query in the format of run_batch, each answer is one line, in the order of the queries.
+ * Queries are read ahead of the answers, up to the queue size, so a client may send many before reading
+ * @param in Stream with the queries, the server stops at its end
+ * @param out Stream where the answers are written, flushed whenever no answer is pending
+ * @param pool Threads that answer the queries
+ * @brief Complexity O(q) queries, each with the complexity of its algorithm
+ */
+void serve_stream(istream& in, ostream& out, QueryPool& pool);
+
+/** Function that listens on a Unix domain socket and serves every client that connects (see serve_stream) at the same time.
+ * Accepting is retried after an interruption, and after a short pause when the process runs out of descriptors or memory
+ * @param path Path of the socket, a socket already there is replaced but any other file is left alone
+ * @param pool Threads that answer the queries
+ * @return Why the server stopped: the socket cannot be created or clients can no longer be accepted
+ * @brief Complexity O(q) queries, each with the complexity of its algorithm
+ */
+string serve_socket(const string& path, QueryPool& pool);
+
+#endif //DATP1_SERVER_H
@@ -0,0 +1,43 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_SNAPSHOT_H
+#define DATP1_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+/** Version of the snapshot layout, snapshots written with any other version are ignored */
+const uint32_t SNAPSHOT_VERSION = 3;
+
+/** Function that returns where the snapshot of a dataset is kept
+ * @param network_file String with the name of the network file of the dataset
+ * @return String with the name of the snapshot file
+ * @brief Complexity O(1)
+ */
+string snapshot_path(const string& network_file);
+
+/** Function that writes the loaded dataset (interned strings, stations, graph adjacency in CSR form, station limits, connections and
+ * the district and municipality aggregates) to a binary snapshot, stamped with the size and modification time of its csv files
+ * @param file String with the name of the snapshot file
+ * @param stations_file String with the name of the stations file the dataset was read from
+ * @param network_file String with the name of the network file the dataset was read from
+ * @return True if the snapshot was written, false otherwise
+ * @brief Complexity O(n + m), where n is the number of stations and m is the number of connections
+ */
+bool write_snapshot(const string& file, const string& stations_file, const string& network_file);
+
+/** Function that maps a binary snapshot into memory and rebuilds the dataset from it. Nothing is loaded if the snapshot is
+ * missing, was written by another version, fails its checksum or is older than the csv files it was made from
+ * @param file String with the name of the snapshot file
+ * @param stations_file String with the name of the stations file of the dataset
+ * @param network_file String with the name of the network file of the dataset
+ * @return True if the dataset was loaded, false if the csv files have to be read instead
+ * @brief Complexity O(n + m), where n is the number of stations and m is the number of connections
+ */
+bool load_snapshot(const string& file, const string& stations_file, const string& network_file);
+
+#endif //DATP1_SNAPSHOT_H
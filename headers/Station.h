@@ -5,29 +5,38 @@
 #ifndef DATP1_STATION_H
 #define DATP1_STATION_H
 
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include "StringPool.h"
 
 using namespace std;
 
 class Station{
 
-    /** String with the name of the station*/
-    string name;
+    /** Id of the name of the station in the string pool*/
+    uint32_t name = StringPool::npos;
 
-    /** String with the district of the station*/
-    string district;
+    /** Id of the district of the station in the string pool*/
+    uint32_t district = StringPool::npos;
 
-    /** String with the municipality of the station*/
-    string municipality;
+    /** Id of the municipality of the station in the string pool*/
+    uint32_t municipality = StringPool::npos;
 
-    /** String with the township of the station*/
-    string township;
+    /** Id of the township of the station in the string pool*/
+    uint32_t township = StringPool::npos;
 
-    /** String with the tline of the station*/
-    string tline;
+    /** Id of the tline of the station in the string pool*/
+    uint32_t tline = StringPool::npos;
 
 public:
 
+    /** String pool shared by every station
+     * @return Pool where the names, districts, municipalities, townships and tlines are interned
+     * @brief Complexity O(1)
+     */
+    static StringPool &strings();
+
     /** Default Constructor
      * @brief Complexity O(1)
      */
@@ -39,69 +48,109 @@ public:
      * @param municipality String with the municipality of the station
      * @param township String with the township of the station
      * @param tline String with the tline of the station
+     * @brief Complexity O(n), where n is the total length of the strings
+     */
+    Station(string_view name, string_view district, string_view municipality, string_view township, string_view tline);
+
+    /** Constructor from already interned strings
+     * @param name Id of the name of the station
+     * @param district Id of the district of the station
+     * @param municipality Id of the municipality of the station
+     * @param township Id of the township of the station
+     * @param tline Id of the tline of the station
      * @brief Complexity O(1)
      */
-    Station(string name, string district, string municipality, string township, string tline);
+    Station(uint32_t name, uint32_t district, uint32_t municipality, uint32_t township, uint32_t tline);
 
     /** Getter
      * @return String with the name of the station
      * @brief Complexity O(1)
      */
-    string getName() const;
+    string_view getName() const;
 
     /** Getter
      * @return String with the district of the station
      * @brief Complexity O(1)
      */
-    string getDistrict() const;
+    string_view getDistrict() const;
 
     /** Getter
      * @return String with the municipality of the station
      * @brief Complexity O(1)
      */
-    string getMunicipality() const;
+    string_view getMunicipality() const;
 
     /** Getter
      * @return String with the township of the station
      * @brief Complexity O(1)
      */
-    string getTownship() const;
+    string_view getTownship() const;
 
     /** Getter
      * @return String with the tline of the station
      * @brief Complexity O(1)
      */
-    string getTline() const;
+    string_view getTline() const;
+
+    /** Getter
+     * @return Id of the name of the station
+     * @brief Complexity O(1)
+     */
+    uint32_t getNameId() const;
+
+    /** Getter
+     * @return Id of the district of the station
+     * @brief Complexity O(1)
+     */
+    uint32_t getDistrictId() const;
+
+    /** Getter
+     * @return Id of the municipality of the station
+     * @brief Complexity O(1)
+     */
+    uint32_t getMunicipalityId() const;
+
+    /** Getter
+     * @return Id of the township of the station
+     * @brief Complexity O(1)
+     */
+    uint32_t getTownshipId() const;
+
+    /** Getter
+     * @return Id of the tline of the station
+     * @brief Complexity O(1)
+     */
+    uint32_t getTlineId() const;
 
     /** Setter
      * @param name String with the name of the station
-     * @brief Complexity O(1)
+     * @brief Complexity O(n), where n is the length of the string
      */
-    void setName(string name);
+    void setName(string_view name);
 
     /** Setter
      * @param district String with the district of the station
-     * @brief Complexity O(1)
+     * @brief Complexity O(n), where n is the length of the string
      */
-    void setDistrict(string district);
+    void setDistrict(string_view district);
 
     /** Setter
      * @param municipality String with the municipality of the station
-     * @brief Complexity O(1)
+     * @brief Complexity O(n), where n is the length of the string
      */
-    void setMunicipality(string municipality);
+    void setMunicipality(string_view municipality);
 
     /** Setter
      * @param township String with the township of the station
-     * @brief Complexity O(1)
+     * @brief Complexity O(n), where n is the length of the string
      */
-    void setTownship(string township);
+    void setTownship(string_view township);
 
     /** Setter
      * @param tline String with the tline of the station
-     * @brief Complexity O(1)
+     * @brief Complexity O(n), where n is the length of the string
      */
-    void setTline(string tline);
+    void setTline(string_view tline);
 
 };
 
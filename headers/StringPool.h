@@ -0,0 +1,64 @@
+//
+// Created by Utilizador on 18/10/2026.
+//
+
+#ifndef DATP1_STRINGPOOL_H
+#define DATP1_STRINGPOOL_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace std;
+
+/** Table of interned strings, every distinct string is stored once and identified by a small integer id */
+class StringPool{
+
+    /** Stored strings, a deque keeps their addresses stable while the pool grows */
+    deque<string> strings;
+
+    /** Map with the ids of the strings, key = view over a stored string, value = id */
+    unordered_map<string_view, uint32_t> ids;
+
+public:
+
+    /** Id returned when a string is not in the pool */
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    /** Interns a string
+     * @param s String to intern
+     * @return Id of the string, a new one if it was not in the pool yet
+     * @brief Complexity O(|s|)
+     */
+    uint32_t intern(string_view s);
+
+    /** Looks up a string without interning it
+     * @param s String to look up
+     * @return Id of the string, or npos if it was never interned
+     * @brief Complexity O(|s|)
+     */
+    uint32_t find(string_view s) const;
+
+    /** Getter
+     * @param id Id of an interned string
+     * @return View over the interned string, valid for as long as the pool is not cleared
+     * @brief Complexity O(1)
+     */
+    string_view get(uint32_t id) const;
+
+    /** Getter
+     * @return Number of interned strings
+     * @brief Complexity O(1)
+     */
+    size_t size() const;
+
+    /** Removes every string from the pool, invalidating all ids and views
+     * @brief Complexity O(n), where n is the number of strings
+     */
+    void clear();
+
+};
+
+#endif //DATP1_STRINGPOOL_H
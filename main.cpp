@@ -9,49 +9,27 @@
 #include <sstream>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <list>
-#include "headers/Station.h"
-#include "DataStructures/Graph.h"
+#include "headers/Batch.h"
+#include "headers/Dataset.h"
+#include "headers/Delta.h"
+#include "headers/Queries.h"
+#include "headers/Server.h"
+#include "DataStructures/GraphStats.h"
 
 using namespace std;
 
-Graph g;
-
-/** Struct with the information of a connection: id1, id2, capacity, service */
-typedef pair<pair<int, int>, pair<int, string>> edge;
-
-/** Map with the stations, key = station id, value = Station */
-unordered_map<int, Station> stations;
-
-/** Map with the names of the stations, key = station name, value = station id */
-unordered_map<string, int> stations_name;
-
-/** Map with the connections, key = connection id, value = edge */
-unordered_map<int, edge> connections;
-
-/** Map with the districts, key = district name, value = number of stations */
-unordered_map<string, int> districts;
-
-/** Map with the municipalities, key = municipality name, value = number of stations */
-unordered_map<string, int> municipalities;
-
-/** Function that reads the stations from a file and stores them in the stations, stations_name, districts and municipalities maps
- * @param file String with the name of the file
- * @brief Complexity O(n), where n is the number of stations
- */
-void read_stations(const string& file);
-
-/** Function that reads the connections from a file and stores them in the connections map, also adds the numbers of stations in each district and municipality to their respective maps
- * @param file String with the name of the file
- * @brief Complexity O(n), where n is the number of connections
- */
-void read_network(const string& file);
-
 /** Function that prints the main menu
  * @brief Complexity O(1)
  */
 void print_menu();
 
+/** Function that applies a file of updates (segment closures, capacity changes, new stations) to the loaded dataset
+ * @brief Complexity O(u*m) where u is the number of updates and m is the number of connections
+ */
+void print_updates();
+
 /** Function that prints the first menu
  * @brief Complexity O(1)
  */
@@ -73,7 +51,7 @@ void print_menu_1();
 void print_menu_2();
 
 /** Function that prints the menu of the third option
- * @brief Complexity O(|V|^2) where n is the number of connections
+ * @brief Complexity O(r*|V|*|E|^2 / t) where r is the number of regions and t the number of threads
  */
 void print_menu_3();
 
@@ -107,15 +85,12 @@ void print_menu_2_1();
  */
 void print_menu_2_2();
 
-/** Function that prints the top districts with the most stations
- * @brief Complexity O(nlogn) where n is the number of districts
- */
-void top_d();
-
-/** Function that prints the top municipalities with the most stations
- * @brief Complexity O(nlogn) where n is the number of municipalities
+/** Function that prints the top regions of a kind by their transportation needs, the max flow into their stations
+ * @param kind What the stations are grouped by
+ * @param name Plural name of the regions, for the messages
+ * @brief Complexity O(r*|V|*|E|^2 / t) where r is the number of regions and t the number of threads
  */
-void top_m();
+void top_regions(RegionKind kind, const string& name);
 
 /** Function that checks if a station exists in the stations map
  * @param s String with the name of the station
@@ -124,6 +99,12 @@ void top_m();
  */
 bool checkStation(const string& s);
 
+/** Function that asks which services the trains can use
+ * @return Mask of the services, ALL_SERVICES if the answer is ALL
+ * @brief Complexity O(n) where n is the length of the answer
+ */
+unsigned int read_services();
+
 /** Function that checks if a connection exists in the connections map
  * @param id1 Integer with the id of the first station
  * @param id2 Integer with the id of the second station
@@ -132,32 +113,20 @@ bool checkStation(const string& s);
  */
 bool checkConnection(const int &id1, const int &id2);
 
-/** Function that returns the max flow of a station by extending augmenting the graph to make it with one source and one sink
- * @param station String with the name of the station
- * @return Double with the max flow of the station
- * @brief Complexity O(|V|^2*|E|^2) where n is the number of connections
+/** Function that prints and resets the algorithm counters of the last query, when --stats was given
+ * @brief Complexity O(1)
  */
-double superSource(const std::string &station) {
-    auto it = stations_name.find(station);
-
-    auto cpy = g;
-    cpy.addVertex(1000);
-    for (auto v : cpy.getVertexSet()) {
-        if (v->getAdj().size() == 1 && v->getId() != 1000) {
-            cpy.findVertex(1000)->addEdge(v, INF, 0);
-        }
-    }
-
-    cpy.edmondsKarp(1000, it->second);
-
-    double maxFlow = 0;
-    for (auto e : cpy.findVertex(it->second)->getIncoming()) maxFlow += e->getFlow();
-    return maxFlow;
-}
+void print_stats();
 
 void clear() {for (int i = 0; i < 50; i++) cout << endl;}
 void wait() {cin.ignore(numeric_limits<streamsize>::max(), '\n'); cin.get();}
 
+void print_stats() {
+    if (!graphStats().enabled) return;
+    graphStats().print(cout);
+    graphStats().reset();
+}
+
 string station_ = "../files/stations.csv";
 string network_ = "../files/network.csv";
 
@@ -185,13 +154,11 @@ void print_main() {
 
     switch (choice) {
         case 1:
-            read_stations(station_);
-            read_network(network_);
+            load_dataset(station_, network_);
             choice = 0;
             break;
         case 2:
-            read_stations(demo_stations_);
-            read_network(demo_networks_);
+            load_dataset(demo_stations_, demo_networks_);
             choice = 0;
             break;
         default:
@@ -203,87 +170,95 @@ void print_main() {
     }
 }while (choice != 0);
 
+    graphStats().reset();
     print_menu();
 }
-int main() {
-
-    print_main();
-
-    return 0;
-}
-
-
-
-void read_stations(const string& file){
-    ifstream stations_file(file);
-
-    string line;
-
-    int i = 1;
-    getline(stations_file, line);
-    while(getline(stations_file, line)){
-        stringstream ss(line);
-        string name, district, municipality, township, tline;
-        getline(ss, name, ',');
-        getline(ss, district, ',');
-        getline(ss, municipality, ',');
-        getline(ss, township, ',');
-        getline(ss, tline, ',');
-
-        Station station(name, district, municipality, township, tline);
-        stations.insert({i, station});
-        stations_name.insert({name, i});
-        municipalities.insert({municipality, 0});
-        districts.insert({district, 0});
-
-        g.addVertex(i);
-
-        i++;
+int main(int argc, char* argv[]) {
+    string dataset, queries, output, serve, pairs;
+    bool sweep = false, reliability = false;
+    ReliabilityOptions simulation;
+    ServerOptions server;
+    unsigned int services = ALL_SERVICES;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--stats") graphStats().enabled = true;
+        else if (arg == "--dataset" && i + 1 < argc) dataset = argv[++i];
+        else if (arg == "--queries" && i + 1 < argc) queries = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) output = argv[++i];
+        else if (arg == "--serve" && i + 1 < argc) serve = argv[++i];
+        else if (arg == "--sweep") sweep = true;
+        else if (arg == "--pairs" && i + 1 < argc) pairs = argv[++i];
+        else if (arg == "--reliability") reliability = true;
+        else if (arg == "--failure" && i + 1 < argc) simulation.failure = atof(argv[++i]);
+        else if (arg == "--seed" && i + 1 < argc) simulation.seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--scenarios" && i + 1 < argc) simulation.maxScenarios = max(1, atoi(argv[++i]));
+        else if (arg == "--precision" && i + 1 < argc) simulation.precision = atof(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc) server.threads = max(1, atoi(argv[++i]));
+        else if (arg == "--queue" && i + 1 < argc) server.queue = max(1, atoi(argv[++i]));
+        else if (arg == "--cache" && i + 1 < argc) setCacheCapacity((size_t) max(0, atoi(argv[++i])));
+        else if (arg == "--services" && i + 1 < argc && parse_services(argv[i + 1], services)) i++;
+        else {
+            cerr << "Usage: DATP1 [--stats] [--cache N] [--dataset full|demo (--queries FILE [--output FILE] | --serve stdin|SOCKET [--threads N] [--queue N] | --sweep [--pairs FILE] [--services S] [--output FILE] [--threads N]"
+                    " | --reliability --pairs FILE [--services S] [--failure P] [--seed N] [--scenarios N] [--precision TRAINS] [--output FILE] [--threads N])]" << endl;
+            return 1;
+        }
     }
-}
-
-void read_network(const string& file){
-
-    ifstream network_file(file);
 
-    string line;
-
-    int i = 1, price;
-    getline(network_file, line);
-    while(getline(network_file, line)){
-        price = 4;
-        istringstream ss(line);
-        string station1, station2, service;
-        int capacity;
-        getline(ss, station1, ',');
-        getline(ss, station2, ',');
-        ss >> capacity;
-        ss.ignore();
-        getline(ss, service, ',');
-
-        if(service == "STANDARD") {price = 2;}
+    if (!queries.empty() || !serve.empty() || sweep || reliability) {
+        if (dataset != "full" && dataset != "demo") {
+            cerr << "--dataset must be full or demo" << endl;
+            return 1;
+        }
+        if (dataset == "full") load_dataset(station_, network_);
+        else load_dataset(demo_stations_, demo_networks_);
+        graphStats().reset();
+    }
 
-        auto it1 = stations_name.find(station1);
-        auto it2 = stations_name.find(station2);
+    if (!serve.empty()) {
+        QueryPool pool(server);
+        if (serve == "stdin") {
+            serve_stream(cin, cout, pool);
+            if (graphStats().enabled) graphStats().print(cerr);
+            return 0;
+        }
+        cerr << "Serving " << stations.size() << " stations on " << serve << " with " << server.threads << " threads" << endl;
+        string error = serve_socket(serve, pool);
+        cerr << "Cannot serve on " << serve << ": " << error << endl;
+        return 1;
+    }
 
-        edge temp = {{it1->second, it2->second}, {capacity, service}};
-        connections.insert({i, temp});
+    if (reliability) {
+        simulation.threads = server.threads;
+        BatchResult result = run_reliability_file(pairs, output, simulation, services);
+        for (const auto &error : result.errors) cerr << error << endl;
+        cerr << result.answered << " pairs simulated" << endl;
+        if (graphStats().enabled) graphStats().print(cerr);
+        return result.answered == 0 ? 1 : 0;
+    }
 
-        districts.find(stations.find(it1->second)->second.getDistrict())->second += capacity;
-        districts.find(stations.find(it2->second)->second.getDistrict())->second += capacity;
+    if (sweep) {
+        BatchResult result = run_sweep_file(pairs, output, server.threads, services);
+        for (const auto &error : result.errors) cerr << error << endl;
+        cerr << result.answered << " segments swept" << endl;
+        if (graphStats().enabled) graphStats().print(cerr);
+        return result.answered == 0 ? 1 : 0;
+    }
 
-        municipalities.find(stations.find(it1->second)->second.getMunicipality())->second += capacity;
-        municipalities.find(stations.find(it2->second)->second.getMunicipality())->second += capacity;
+    if (!queries.empty()) {
+        BatchResult result = run_batch_file(queries, output);
+        for (const auto &error : result.errors) cerr << error << endl;
+        cerr << result.answered << " queries answered, " << result.errors.size() << " rejected" << endl;
+        if (graphStats().enabled) graphStats().print(cerr);
+        return result.answered == 0 && !result.errors.empty() ? 1 : 0;
+    }
 
-        g.addBidirectionalEdge(it1->second, it2->second, capacity, price);
+    print_main();
 
-        i++;
-    }
+    return 0;
 }
 
 
 
-
 void print_menu() {
     int choice;
     do {
@@ -292,11 +267,12 @@ void print_menu() {
         cout << "|        Railway Network Manager         |" << endl;
         cout << "| 1. Use Dataset                         |" << endl;
         cout << "| 2. Check Dataset                       |" << endl;
+        cout << "| 3. Apply Updates                       |" << endl;
         cout << "| 0. Exit                                |" << endl;
         cout << "------------------------------------------" << endl;
 
         cin >> choice;
-        if (choice < 0 || choice > 2) {
+        if (choice < 0 || choice > 3) {
             cout << "Invalid option! Try again" << endl;
             cin >> choice;
             cout << endl;
@@ -309,6 +285,10 @@ void print_menu() {
                 case 2:
                     print_first_menu_2();
                     break;
+                case 3:
+                    clear();
+                    print_updates();
+                    break;
                 default:
                     break;
             }
@@ -449,15 +429,12 @@ void print_menu_1(){
     }
     cout << endl;
 
-    double sum = 0;
+    unsigned int services = read_services();
+    cout << endl;
 
-    auto it1 = stations_name.find(station1);
-    auto it2 = stations_name.find(station2);
-    g.edmondsKarp(it1->second, it2->second);
-    for (const auto e : g.findVertex(it1->second)->getAdj()) {
-        sum += e->getFlow();
-    }
+    double sum = maxFlow(findStation(station1), findStation(station2), services);
     cout << "Maximum Flow : " << sum << endl; cout << endl;
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 }
@@ -466,7 +443,10 @@ void print_menu_1(){
 
 void print_menu_2() {
 
-    auto lista = g.mostTrains();
+    unsigned int services = read_services();
+    cout << endl;
+
+    auto lista = g.mostTrains(services);
 
     for(auto par : lista) {
         cout << stations.find(par.first)->second.getName() << " - " << stations.find(par.second)->second.getName() << endl;
@@ -488,6 +468,7 @@ void print_menu_2() {
     }
 */
     cout << endl;
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 }
@@ -502,13 +483,15 @@ void print_menu_3(){
         cout << endl;
         cout << "   1 - View Districts " << endl;
         cout << "   2 - View Municipalities " << endl;
+        cout << "   3 - View Townships " << endl;
+        cout << "   4 - View Lines " << endl;
         cout << endl;
         cout << "   0 - Go back" << endl;
         cout << endl;
         cout << endl;
 
         cin >> choice;
-        if (choice < 0 || choice > 2) {
+        if (choice < 0 || choice > 4) {
             cout << "Invalid option! Try again" << endl;
             cin >> choice;
             cout << endl;
@@ -518,10 +501,16 @@ void print_menu_3(){
                 choice = 0;
                 break;
             case 1:
-                top_d();
+                top_regions(RegionKind::District, "districts");
                 break;
             case 2:
-                top_m();
+                top_regions(RegionKind::Municipality, "municipalities");
+                break;
+            case 3:
+                top_regions(RegionKind::Township, "townships");
+                break;
+            case 4:
+                top_regions(RegionKind::Line, "lines");
                 break;
             default:
                 break;
@@ -545,10 +534,15 @@ void print_menu_4(){
         cout << endl;
     }
 
-    double maxFlow = superSource(station);
+    cout << endl;
+    unsigned int services = read_services();
+    cout << endl;
+
+    double maxFlow = superSource(findStation(station), services);
 
     cout << "The maximum number of trains that can simultaneously arrive at " << station << " is " << maxFlow << endl;
     cout << endl;
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 }
@@ -588,30 +582,27 @@ void print_menu_5() {
     }
     cout << endl;
 
-    auto st1 = stations_name.find(station1);
-    auto st2 = stations_name.find(station2);
+    int id1 = findStation(station1);
+    int id2 = findStation(station2);
 
-    g.dijkstra(st1->second);
+    unsigned int services = read_services();
+    cout << endl;
 
-    vector<string> path;
-    int id = st2->second;
-    while(id != st1->second) {
-        path.push_back(stations.find(id)->second.getName());
-        auto test = g.findVertex(id);
-        if(test == nullptr) break;
-        id = test->getPath()->getOrig()->getId(); //BUG
+    Route route = cheapestRoute(id1, id2, services);
+    if (route.stations.empty()) {
+        cout << "There is no route between " << station1 << " and " << station2 << endl;
     }
-
-    cout << stations.find(st1->second)->second.getName() << " -> ";
-    for(int i = path.size()-1; i >= 0; i--) {
-        cout << path[i];
-        if(i != 0) cout << " -> ";
+    else {
+        for (size_t i = 0; i < route.stations.size(); i++) {
+            cout << stations.find(route.stations[i])->second.getName();
+            if (i + 1 != route.stations.size()) cout << " -> ";
+        }
+        cout << endl; cout << endl;
+        cout << route.trains << " trains, costing " << route.cost;
     }
-    cout << endl; cout << endl;
-    auto station = g.findVertex(st2->second);
-    cout << station->getDist() << " trains, costing " << station->getCost();
 
     cout << endl;
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 }
@@ -653,10 +644,10 @@ void print_menu_6(){
         }
         cout << endl;
 
-        auto it1 = stations_name.find(station1);
-        auto it2 = stations_name.find(station2);
+        int id1 = findStation(station1);
+        int id2 = findStation(station2);
 
-        if(!checkConnection(it1->second, it2->second)){
+        if(!checkConnection(id1, id2)){
             cout << endl;
             cout << "There is no connection between " << station1 << " and " << station2 << endl;
             cout << "Try again" << endl;
@@ -692,11 +683,9 @@ void print_menu_6(){
     } while (choice != 0);
 
 
-    Graph tmp = g;
+    vector<pair<int, int>> segments;
     for(const auto& station : stations_6){
-        auto it1 = stations_name.find(station.first);
-        auto it2 = stations_name.find(station.second);
-        tmp.removeEdge(it1->second, it2->second);
+        segments.emplace_back(findStation(station.first), findStation(station.second));
     }
 
     //prints the remaining edges after removal
@@ -746,15 +735,12 @@ void print_menu_6(){
     }
     cout << endl;
 
-    double sum = 0;
+    unsigned int services = read_services();
+    cout << endl;
 
-    auto it1 = stations_name.find(station1);
-    auto it2 = stations_name.find(station2);
-    g.edmondsKarp(it1->second, it2->second);
-    for (const auto e : g.findVertex(it1->second)->getAdj()) {
-        sum += e->getFlow();
-    }
+    double sum = maxFlowWithout(segments, findStation(station1), findStation(station2), services);
     cout << "Maximum Flow : " << sum << endl; cout << endl;
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 }
@@ -794,10 +780,10 @@ void print_menu_7(){
         }
         cout << endl;
 
-        auto it1 = stations_name.find(station1);
-        auto it2 = stations_name.find(station2);
+        int id1 = findStation(station1);
+        int id2 = findStation(station2);
 
-        if(!checkConnection(it1->second, it2->second)){
+        if(!checkConnection(id1, id2)){
             cout << endl;
             cout << "There is no connection between " << station1 << " and " << station2 << endl;
             cout << "Try again" << endl;
@@ -822,30 +808,16 @@ void print_menu_7(){
 
     } while (choice != 0);
 
-    std::vector<double> flowBefore(g.getNumVertex(), 0);
-    for (int i = 1; i < g.getNumVertex(); i++) flowBefore[i] = superSource(stations[i].getName());
-
-    Graph tmp = g;
+    vector<pair<int, int>> segments;
     for(const auto& station : stations_7){
-        auto it1 = stations_name.find(station.first);
-        auto it2 = stations_name.find(station.second);
-        tmp.removeEdge(it1->second, it2->second);
+        segments.emplace_back(findStation(station.first), findStation(station.second));
     }
+    unsigned int services = read_services();
+    cout << endl;
 
-    std::vector<double> flowAfter(tmp.getNumVertex(), 0);
-    for (int i = 1; i < tmp.getNumVertex(); i++) flowAfter[i] = superSource(stations[i].getName());
-
-    std::vector<double> diff(tmp.getNumVertex(), 0);
-    for (int i = 1; i < tmp.getNumVertex(); i++) diff[i] = flowAfter[i] - flowBefore[i];
-
-    /*while(!stations_7.empty()){
-        cout << endl;
-        for(auto edge : tmp.findVertex(stations_name.find(stations_7.begin()->first)->second)->getAdj() ){
-            cout << stations.find(edge->getDest()->getId())->second.getName() << endl;
-        }
-        stations_7.erase(stations_7.begin());
-    }*/
+    auto diff = failureImpact(segments, 10, services);
 
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 
@@ -857,14 +829,8 @@ void print_menu_7(){
         cin >> x;
     }
 
-    std::vector<std::string> affected;
-
-    for (int i = 0; i < x; i++) {
-        int maxDiff = 0;
-        for (int j = 1; j < diff.size(); j++) maxDiff = std::abs(diff[j]) > std::abs(diff[maxDiff]) ? j : maxDiff;
-        affected.push_back(stations[maxDiff].getName());
-        diff[maxDiff] = 0;
-    }
+    std::vector<std::string_view> affected;
+    for (int i = 0; i < x && i < (int) diff.size(); i++) affected.push_back(stations[diff[i].first].getName());
 
     cout << "The most affected stations are:\n";
     for (const auto &station : affected) {
@@ -875,6 +841,21 @@ void print_menu_7(){
     wait();
 }
 
+void print_updates(){
+    string file;
+    cout << "Enter the name of the updates file: ";
+    getline(cin >> ws, file);
+
+    DeltaEffect effect = apply_delta_file(file);
+    forgetChanges(effect);
+    cout << endl;
+    cout << effect.applied << " updates applied, " << effect.stations.size() << " stations affected" << endl;
+    for (const auto &error : effect.errors) cout << error << endl;
+    cout << endl;
+    cout << "Press enter to continue..." << endl;
+    wait();
+}
+
 void print_menu_2_1(){
     // prints every station
     cout << "Here is the name of every station: " << endl;
@@ -894,9 +875,7 @@ void print_menu_2_2(){
     cout << "Here is every connection: " << endl;
     cout << endl;
     for(const auto& con : connections){
-        auto st1 = stations.find(con.second.first.first);
-        auto st2 = stations.find(con.second.first.second);
-        cout << st1->second.getName() << " <-> " << st2->second.getName() << endl;
+        cout << stations.find(con.second.first.first)->second.getName() << " <-> " << stations.find(con.second.first.second)->second.getName() << endl;
     }
     cout << endl;
     cout << "Press enter to continue..." << endl;
@@ -904,7 +883,7 @@ void print_menu_2_2(){
 }
 
 bool checkStation(const string& s) {
-    if(stations_name.find(s) == stations_name.end()){
+    if(findStation(s) == -1){
         clear();
         return false;
     }
@@ -912,75 +891,50 @@ bool checkStation(const string& s) {
     return true;
 }
 
-void top_d(){
-    unordered_map<string, int> tmp = districts;
-    vector<string> districts_top;
-        cout << "Select an integer between 1 and 18 to see the top x districts" << endl;
-        int x;
-        cin >> x;
-
-
-        if (x < 1 || x > 18) {
-            cout << "Invalid option! Try again" << endl;
-            cin >> x;
-            cout << endl;
-        }
-        cout << "Top " << x << " districts" << endl;
-
-
-        for (int i = x; i > 0; i--) {
-            int max = 0;
-            string district;
-            for (const auto& d: tmp) {
-                if (d.second >= max) {
-                    max = d.second;
-                    district = d.first;
-                }
-            }
-            tmp.erase(district);
-            districts_top.push_back(district);
-        }
-        for (const auto& d: districts_top) {
-            cout << d << endl;
-        }
+unsigned int read_services() {
+    string field;
+    cout << "Enter the services the trains can use (STANDARD, ALFA PENDULAR, both joined by '+', or ALL): ";
+    while (true) {
+        getline(cin >> ws, field);
+        if (field == "ALL") return ALL_SERVICES;
+        unsigned int services;
+        if (parse_services(field, services)) return services;
         cout << endl;
-        cout << "Press enter to continue..." << endl;
-        wait();
+        cout << "Service " << field << " does not exist! Try again:" << endl;
+    }
 }
 
-void top_m(){
-    unordered_map<string, int> tmp_m = municipalities;
-    vector<string> municipalities_top;
-    cout << endl;
-    cout << "Select an integer between 1 and 50 to see the top x municipalities" << endl;
-    int y;
-    cin >> y;
 
+void top_regions(RegionKind kind, const string& name){
+    unordered_set<uint32_t> regions;
+    for (const auto &s : stations) {
+        switch (kind) {
+            case RegionKind::District: regions.insert(s.second.getDistrictId()); break;
+            case RegionKind::Municipality: regions.insert(s.second.getMunicipalityId()); break;
+            case RegionKind::Township: regions.insert(s.second.getTownshipId()); break;
+            case RegionKind::Line: regions.insert(s.second.getTlineId()); break;
+        }
+    }
+    int n = max(1, (int) regions.size());
 
-    if (y < 1 || y > 50) {
+    cout << endl;
+    cout << "Select an integer between 1 and " << n << " to see the top x " << name << endl;
+    int x;
+    cin >> x;
+    while (x < 1 || x > n) {
         cout << "Invalid option! Try again" << endl;
-        cin >> y;
-        cout << endl;
+        cin >> x;
     }
 
-    cout << "Top " << y << " municipalities" << endl;
+    unsigned int services = read_services();
+    cout << endl;
 
-    for (int i = y; i > 0; i--) {
-        int max = 0;
-        string municipality;
-        for (const auto& m: tmp_m) {
-            if (m.second >= max) {
-                max = m.second;
-                municipality = m.first;
-            }
-        }
-        tmp_m.erase(municipality);
-        municipalities_top.push_back(municipality);
-    }
-    for (const auto& m: municipalities_top) {
-        cout << m << endl;
+    cout << "Top " << x << " " << name << ", by the maximum number of trains that can simultaneously arrive at their stations" << endl;
+    for (const auto &r : topRegionsByFlow(kind, x, services)) {
+        cout << Station::strings().get(r.first) << " - " << r.second << endl;
     }
     cout << endl;
+    print_stats();
     cout << "Press enter to continue..." << endl;
     wait();
 }